@@ -0,0 +1,252 @@
+#include "AudioTrace.h"
+
+#include <algorithm>
+
+namespace
+{
+    // Chrome trace "threads": one track per engine context, then one per slot
+    constexpr int kCallbackTrack = 1;
+    constexpr int kRenderAheadTrack = 2;
+    constexpr int kMessageTrack = 3;
+    constexpr int kFirstSlotTrack = 100;
+
+    uint64_t pack(uint8_t type, int slot, int value) noexcept
+    {
+        return (uint64_t)type
+             | ((uint64_t)(uint16_t)slot << 8)
+             | ((uint64_t)(uint32_t)value << 32);
+    }
+}
+
+//==============================================================================
+class AudioTrace::ExportThread : public juce::Thread
+{
+public:
+    ExportThread(const AudioTrace& o, const juce::File& f, std::function<void(bool)> done)
+        : juce::Thread("Trace export"), owner(o), file(f), onDone(std::move(done))
+    {
+    }
+
+    void run() override
+    {
+        const bool written = writeChromeTrace(owner.copyEvents(), file);
+
+        if (onDone)
+            onDone(written);
+    }
+
+private:
+    const AudioTrace& owner;
+    const juce::File file;
+    std::function<void(bool)> onDone;
+};
+
+//==============================================================================
+AudioTrace::AudioTrace() = default;
+
+AudioTrace::~AudioTrace()
+{
+    if (exportThread != nullptr)
+        exportThread->stopThread(10000);
+}
+
+void AudioTrace::append(Type type, int slot, int value) noexcept
+{
+    const auto pos = writePosition.fetch_add(1, std::memory_order_relaxed);
+    auto& cell = cells[(size_t)(pos & kMask)];
+
+    // Seqlock write: mark the cell busy, fill it, then publish it under its position
+    cell.sequence.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    cell.ticks.store(juce::Time::getHighResolutionTicks(), std::memory_order_relaxed);
+    cell.payload.store(pack((uint8_t)type, slot, value), std::memory_order_relaxed);
+    cell.sequence.store(pos + 1, std::memory_order_release);
+}
+
+// Cells being written, or overwritten since the copy began, fail the sequence check and are skipped
+std::vector<AudioTrace::Event> AudioTrace::copyEvents() const
+{
+    const auto end = writePosition.load(std::memory_order_acquire);
+    const auto begin = end > (uint64_t)kCapacity ? end - (uint64_t)kCapacity : 0;
+
+    std::vector<Event> events;
+    events.reserve((size_t)(end - begin));
+
+    for (auto pos = begin; pos < end; ++pos)
+    {
+        const auto& cell = cells[(size_t)(pos & kMask)];
+        if (cell.sequence.load(std::memory_order_acquire) != pos + 1)
+            continue;
+
+        const auto ticks = cell.ticks.load(std::memory_order_relaxed);
+        const auto payload = cell.payload.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+
+        if (cell.sequence.load(std::memory_order_relaxed) != pos + 1)
+            continue;
+
+        Event event;
+        event.ticks = ticks;
+        event.type = (Type)(payload & 0xff);
+        event.slot = (int)(int16_t)(uint16_t)((payload >> 8) & 0xffff);
+        event.value = (int)(uint32_t)(payload >> 32);
+        events.push_back(event);
+    }
+
+    // Threads take positions and timestamps in slightly different orders
+    std::stable_sort(events.begin(), events.end(),
+                     [](const Event& a, const Event& b) { return a.ticks < b.ticks; });
+    return events;
+}
+
+bool AudioTrace::exportChromeTrace(const juce::File& file, std::function<void(bool)> onDone)
+{
+    if (exportThread != nullptr && exportThread->isThreadRunning())
+        return false;
+
+    exportThread = std::make_unique<ExportThread>(*this, file, std::move(onDone));
+    exportThread->startThread(juce::Thread::Priority::low);
+    return true;
+}
+
+// Blocks and pattern swaps become complete ("X") events, voices become slices on their slot's
+// track from start to end or steal, and everything else is an instant event
+bool AudioTrace::writeChromeTrace(const std::vector<Event>& events, const juce::File& file)
+{
+    juce::FileOutputStream out(file);
+    if (!out.openedOk())
+        return false;
+
+    out.setPosition(0);
+    out.truncate();
+
+    const juce::int64 origin = events.empty() ? 0 : events.front().ticks;
+    auto micros = [](juce::int64 ticks)
+    {
+        return juce::String(juce::Time::highResolutionTicksToSeconds(ticks) * 1.0e6, 3);
+    };
+
+    bool first = true;
+    auto writeEvent = [&out, &first](const juce::String& json)
+    {
+        out << (first ? "\n" : ",\n") << json;
+        first = false;
+    };
+
+    auto slotTrack = [](int slot) { return kFirstSlotTrack + juce::jmax(0, slot); };
+
+    auto complete = [&](const char* name, int track, juce::int64 start, juce::int64 end, const juce::String& args)
+    {
+        writeEvent("{\"name\":\"" + juce::String(name) + "\",\"ph\":\"X\",\"pid\":1,\"tid\":" + juce::String(track)
+                   + ",\"ts\":" + micros(start - origin) + ",\"dur\":" + micros(end - start)
+                   + ",\"args\":{" + args + "}}");
+    };
+
+    auto instant = [&](const char* name, int track, juce::int64 ticks, const juce::String& args)
+    {
+        writeEvent("{\"name\":\"" + juce::String(name) + "\",\"ph\":\"i\",\"s\":\"t\",\"pid\":1,\"tid\":" + juce::String(track)
+                   + ",\"ts\":" + micros(ticks - origin) + ",\"args\":{" + args + "}}");
+    };
+
+    auto metadata = [&](const char* kind, int track, const juce::String& name)
+    {
+        writeEvent("{\"name\":\"" + juce::String(kind) + "\",\"ph\":\"M\",\"pid\":1,\"tid\":" + juce::String(track)
+                   + ",\"args\":{\"name\":\"" + name + "\"}}");
+    };
+
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+    metadata("process_name", 0, "Slot Machine");
+    metadata("thread_name", kCallbackTrack, "Audio callback");
+    metadata("thread_name", kRenderAheadTrack, "Render ahead");
+    metadata("thread_name", kMessageTrack, "Message thread");
+
+    std::vector<int> namedSlots;
+
+    // Open intervals; an end whose start was overwritten in the ring is dropped
+    Event blockStart, chunkStart, swapStart;
+    blockStart.ticks = chunkStart.ticks = swapStart.ticks = -1;
+    std::vector<Event> openVoices;
+
+    auto closeVoice = [&](int slot, juce::int64 ticks, const char* how)
+    {
+        for (auto it = openVoices.begin(); it != openVoices.end(); ++it)
+        {
+            if (it->slot != slot)
+                continue;
+
+            complete("voice", slotTrack(slot), it->ticks, ticks,
+                     "\"offset\":" + juce::String(it->value) + ",\"ended\":\"" + how + "\"");
+            openVoices.erase(it);
+            return;
+        }
+    };
+
+    for (const auto& e : events)
+    {
+        if (e.slot >= 0 && std::find(namedSlots.begin(), namedSlots.end(), e.slot) == namedSlots.end())
+        {
+            namedSlots.push_back(e.slot);
+            metadata("thread_name", slotTrack(e.slot), "Slot " + juce::String(e.slot + 1));
+        }
+
+        const auto offsetArg = "\"offset\":" + juce::String(e.value);
+
+        switch (e.type)
+        {
+            case Type::blockStart:          blockStart = e; break;
+            case Type::engineChunkStart:    chunkStart = e; break;
+            case Type::patternSwapStart:    swapStart = e; break;
+
+            case Type::blockEnd:
+                if (blockStart.ticks >= 0)
+                    complete("processBlock", kCallbackTrack, blockStart.ticks, e.ticks,
+                             "\"samples\":" + juce::String(blockStart.value));
+                blockStart.ticks = -1;
+                break;
+
+            case Type::engineChunkEnd:
+                if (chunkStart.ticks >= 0)
+                    complete("engine chunk", kRenderAheadTrack, chunkStart.ticks, e.ticks,
+                             "\"samples\":" + juce::String(chunkStart.value));
+                chunkStart.ticks = -1;
+                break;
+
+            case Type::patternSwapEnd:
+                if (swapStart.ticks >= 0)
+                    complete("pattern swap", kMessageTrack, swapStart.ticks, e.ticks, {});
+                swapStart.ticks = -1;
+                break;
+
+            case Type::hit:
+                instant("hit", slotTrack(e.slot), e.ticks, offsetArg);
+                break;
+
+            case Type::voiceSteal:
+                closeVoice(e.slot, e.ticks, "stolen");
+                instant("steal", slotTrack(e.slot), e.ticks, offsetArg);
+                break;
+
+            case Type::voiceStart:
+                closeVoice(e.slot, e.ticks, "retriggered");
+                openVoices.push_back(e);
+                break;
+
+            case Type::voiceEnd:
+                closeVoice(e.slot, e.ticks, "ran out");
+                break;
+
+            case Type::sampleLoaded:
+                instant("sample loaded", slotTrack(e.slot), e.ticks, "\"samples\":" + juce::String(e.value));
+                break;
+
+            case Type::sampleRetired:
+                instant("sample retired", slotTrack(e.slot), e.ticks, {});
+                break;
+        }
+    }
+
+    out << "\n]}\n";
+    out.flush();
+    return out.getStatus().wasOk();
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+// Flight recorder for the engine. The audio thread, render workers and message thread
+// append small timestamped events to a preallocated ring without locking or allocating,
+// and the ring keeps the most recent kCapacity of them. On request a background thread
+// copies the ring and writes it out as Chrome trace-event JSON, which chrome://tracing
+// and ui.perfetto.dev open directly.
+//
+// Recording starts with setEnabled (true); while disabled, record() is one relaxed load.
+class AudioTrace
+{
+public:
+    static constexpr int kCapacity = 1 << 15;
+
+    enum class Type : uint8_t
+    {
+        blockStart,         // audio callback; value: samples in the block
+        blockEnd,
+        engineChunkStart,   // render-ahead thread; value: samples in the chunk
+        engineChunkEnd,
+        hit,                // value: sample offset in the block
+        voiceStart,         // value: sample offset in the block
+        voiceSteal,         // a retrigger cut off the slot's sounding voice; value: offset
+        voiceEnd,           // the voice ran out during the block
+        patternSwapStart,   // message thread
+        patternSwapEnd,
+        sampleLoaded,       // message thread; value: length in samples, 0 when the load failed
+        sampleRetired       // a sample handed to the release thread
+    };
+
+    AudioTrace();
+    ~AudioTrace();
+
+    // Any thread
+    void setEnabled (bool shouldRecord) noexcept    { enabled.store (shouldRecord, std::memory_order_relaxed); }
+    bool isEnabled() const noexcept                 { return enabled.load (std::memory_order_relaxed); }
+
+    // Any thread; never blocks or allocates. slot is -1 for events that belong to no slot.
+    void record (Type type, int slot = -1, int value = 0) noexcept
+    {
+        if (isEnabled())
+            append (type, slot, value);
+    }
+
+    // Message thread: writes the ring's current contents to file on a background thread and
+    // then calls onDone on that thread. Returns false while an earlier export is running.
+    bool exportChromeTrace (const juce::File& file, std::function<void (bool written)> onDone);
+
+private:
+    struct Event
+    {
+        juce::int64 ticks = 0;
+        Type type = Type::blockStart;
+        int slot = -1;
+        int value = 0;
+    };
+
+    // Sequence is pos + 1 once the event at ring position pos is complete, 0 while it is written
+    struct Cell
+    {
+        std::atomic<uint64_t> sequence { 0 };
+        std::atomic<juce::int64> ticks { 0 };
+        std::atomic<uint64_t> payload { 0 };
+    };
+
+    class ExportThread;
+
+    void append (Type type, int slot, int value) noexcept;
+    std::vector<Event> copyEvents() const;
+    static bool writeChromeTrace (const std::vector<Event>& events, const juce::File& file);
+
+    static constexpr uint64_t kMask = (uint64_t) kCapacity - 1;
+
+    std::array<Cell, (size_t) kCapacity> cells;
+    std::atomic<uint64_t> writePosition { 0 };
+    std::atomic<bool> enabled { false };
+    std::unique_ptr<ExportThread> exportThread;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AudioTrace)
+};
@@ -0,0 +1,320 @@
+#include "AuditionEngine.h"
+
+#include <algorithm>
+#include <cmath>
+
+//==============================================================================
+class AuditionEngine::Loader : public juce::Thread
+{
+public:
+    explicit Loader(AuditionEngine& e)
+        : juce::Thread("Sample audition"), engine(e)
+    {
+        slotFree.fill(true);
+    }
+
+    ~Loader() override
+    {
+        signalThreadShouldExit();
+        wake.signal();
+        stopThread(2000);
+    }
+
+    void requestAudition(const Source& source)
+    {
+        {
+            const juce::ScopedLock sl(requestLock);
+            pendingAudition = source;
+            hasPendingAudition.store(true, std::memory_order_release);
+        }
+
+        wake.signal();
+    }
+
+    void requestPrefetch(const std::vector<Source>& sources)
+    {
+        {
+            const juce::ScopedLock sl(requestLock);
+            pendingPrefetch = sources;
+        }
+
+        wake.signal();
+    }
+
+    void run() override
+    {
+        while (!threadShouldExit())
+        {
+            // Finished voices are only collected here, so poll even when nothing is requested
+            wake.wait(kPollMs);
+            collectRetired();
+
+            Source auditionSource;
+            std::vector<Source> prefetchSources;
+            bool wantAudition = false;
+            {
+                const juce::ScopedLock sl(requestLock);
+                wantAudition = hasPendingAudition.exchange(false, std::memory_order_acq_rel);
+                if (wantAudition)
+                    auditionSource = std::move(pendingAudition);
+                prefetchSources.swap(pendingPrefetch);
+            }
+
+            if (wantAudition)
+                startAudition(auditionSource);
+
+            for (const auto& source : prefetchSources)
+            {
+                // An audition asked for meanwhile goes first; the rest of this prefetch is dropped
+                if (threadShouldExit() || hasPendingAudition.load(std::memory_order_acquire))
+                {
+                    wake.signal();
+                    break;
+                }
+
+                fetch(source);
+            }
+        }
+    }
+
+private:
+    static constexpr int kPollMs = 50;
+
+    struct Prefetched
+    {
+        juce::String name;
+        double sampleRate = 0.0;
+        StoredSample sample;
+    };
+
+    void collectRetired()
+    {
+        engine.retired.popAll([this](const Retired& r)
+            {
+                if (r.slot >= 0)
+                {
+                    engine.slots[(size_t)r.slot].reset();
+                    slotFree[(size_t)r.slot] = true;
+                }
+                else if (r.voice >= 0)
+                {
+                    auto& voice = engine.voices[(size_t)r.voice];
+                    voice.sample.reset();
+                    voice.state.store(idle, std::memory_order_release);
+                }
+            });
+    }
+
+    // Loads source (or finds it among the prefetched) and keeps it as the most recent prefetch
+    StoredSample fetch(const Source& source)
+    {
+        const double rate = engine.sampleRate.load(std::memory_order_acquire);
+
+        // Anything fetched before a sample rate change is no use any more
+        prefetched.erase(std::remove_if(prefetched.begin(), prefetched.end(), [rate](const Prefetched& p)
+            {
+                return p.sampleRate != rate;
+            }), prefetched.end());
+
+        auto it = std::find_if(prefetched.begin(), prefetched.end(), [&](const Prefetched& p)
+            {
+                return p.name == source.name;
+            });
+
+        Prefetched entry;
+        if (it != prefetched.end())
+        {
+            entry = std::move(*it);
+            prefetched.erase(it);
+        }
+        else
+        {
+            entry.name = source.name;
+            entry.sampleRate = rate;
+            if (!engine.load || !engine.load(source, rate, entry.sample) || entry.sample.getNumSamples() <= 0)
+                return {};
+        }
+
+        StoredSample sample = entry.sample;
+        prefetched.insert(prefetched.begin(), std::move(entry));
+        if ((int)prefetched.size() > kMaxPrefetched)
+            prefetched.resize((size_t)kMaxPrefetched);
+
+        return sample;
+    }
+
+    void startAudition(const Source& source)
+    {
+        const auto generation = engine.generation.load(std::memory_order_acquire);
+        auto sample = fetch(source);
+        if (sample.getNumSamples() <= 0)
+            return;
+
+        auto freeSlot = std::find(slotFree.begin(), slotFree.end(), true);
+        if (freeSlot == slotFree.end())
+            return;
+
+        const int slot = (int)std::distance(slotFree.begin(), freeSlot);
+        engine.slots[(size_t)slot] = std::move(sample);
+        slotFree[(size_t)slot] = false;
+
+        if (!engine.commands.push({ slot, generation }))
+        {
+            engine.slots[(size_t)slot].reset();
+            slotFree[(size_t)slot] = true;
+        }
+    }
+
+    AuditionEngine& engine;
+    juce::WaitableEvent wake;
+
+    juce::CriticalSection requestLock;
+    Source pendingAudition;
+    std::atomic<bool> hasPendingAudition{ false };
+    std::vector<Source> pendingPrefetch;
+
+    std::array<bool, (size_t)kNumSlots> slotFree{};
+    std::vector<Prefetched> prefetched;
+};
+
+//==============================================================================
+AuditionEngine::AuditionEngine(LoadFunction loadFunction)
+    : load(std::move(loadFunction))
+{
+    loader = std::make_unique<Loader>(*this);
+    loader->startThread(juce::Thread::Priority::low);
+}
+
+AuditionEngine::~AuditionEngine()
+{
+    loader.reset();
+}
+
+void AuditionEngine::audition(const Source& source)
+{
+    if (source.data != nullptr && source.sizeBytes > 0)
+        loader->requestAudition(source);
+}
+
+void AuditionEngine::prefetch(const std::vector<Source>& sources)
+{
+    loader->requestPrefetch(sources);
+}
+
+void AuditionEngine::prepare(double newSampleRate)
+{
+    sampleRate.store(newSampleRate, std::memory_order_release);
+    generation.fetch_add(1, std::memory_order_acq_rel);
+
+    chokeSamples = juce::jmax(1, juce::roundToInt(newSampleRate * kChokeSeconds));
+    chokeAlpha = (float)std::pow(0.001, 1.0 / (double)chokeSamples);
+
+    stop();
+}
+
+void AuditionEngine::process(juce::AudioBuffer<float>& buffer, int numSamples) noexcept
+{
+    if (stopRequested.exchange(false, std::memory_order_acq_rel))
+        for (auto& voice : voices)
+            if (voice.state.load(std::memory_order_relaxed) == playing)
+                choke(voice);
+
+    commands.popAll([this](const Command& command) { start(command); });
+
+    auto* dstL = buffer.getWritePointer(0);
+    auto* dstR = buffer.getNumChannels() > 1 ? buffer.getWritePointer(1) : nullptr;
+
+    for (int v = 0; v < kNumVoices; ++v)
+    {
+        auto& voice = voices[(size_t)v];
+        if (voice.state.load(std::memory_order_relaxed) != playing)
+            continue;
+
+        const int toProcess = juce::jmin(numSamples, voice.length - voice.index);
+        if (toProcess > 0)
+        {
+            const float gain = voice.sample.getScale();
+            MixKernels::mixSource(voice.sample.getFormat(), voice.sample.getChannel(0), voice.sample.getChannel(1),
+                voice.index, dstL, dstR, toProcess, gain, gain, voice.env);
+            voice.index += toProcess;
+        }
+
+        if (voice.index >= voice.length)
+            release(v);
+    }
+}
+
+bool AuditionEngine::isSounding() const noexcept
+{
+    if (commands.getNumReady() > 0)
+        return true;
+
+    for (const auto& voice : voices)
+        if (voice.state.load(std::memory_order_relaxed) == playing)
+            return true;
+
+    return false;
+}
+
+void AuditionEngine::start(const Command& command) noexcept
+{
+    // Loaded for a sample rate that has since changed
+    if (command.generation != generation.load(std::memory_order_acquire))
+    {
+        retired.push({ command.slot, -1 });
+        return;
+    }
+
+    Voice* target = nullptr;
+    for (auto& voice : voices)
+    {
+        const auto state = voice.state.load(std::memory_order_acquire);
+        if (state == playing)
+        {
+            choke(voice);
+            if (target == nullptr || voice.startOrder < target->startOrder)
+                target = &voice;
+        }
+    }
+
+    // Prefer an idle voice to stealing the oldest playing one
+    for (auto& voice : voices)
+    {
+        if (voice.state.load(std::memory_order_acquire) == idle)
+        {
+            target = &voice;
+            break;
+        }
+    }
+
+    if (target == nullptr)
+    {
+        retired.push({ command.slot, -1 });
+        return;
+    }
+
+    // The slot takes back whatever the voice held, for the loader thread to drop
+    std::swap(target->sample, slots[(size_t)command.slot]);
+    retired.push({ command.slot, -1 });
+
+    // Fades to -60 dB over the sample's length, as slot voices do with their full decay
+    target->index = 0;
+    target->length = target->sample.getNumSamples();
+    target->env.level = 1.0f;
+    target->env.alpha = target->length > 0 ? (float)std::pow(0.001, 1.0 / (double)target->length) : 1.0f;
+    target->startOrder = ++startCounter;
+    target->state.store(playing, std::memory_order_relaxed);
+}
+
+void AuditionEngine::choke(Voice& voice) noexcept
+{
+    voice.env.alpha = juce::jmin(voice.env.alpha, chokeAlpha);
+    voice.length = juce::jmin(voice.length, voice.index + chokeSamples);
+}
+
+void AuditionEngine::release(int voiceIndex) noexcept
+{
+    auto& voice = voices[(size_t)voiceIndex];
+    voice.state.store(released, std::memory_order_release);
+    retired.push({ -1, voiceIndex });
+}
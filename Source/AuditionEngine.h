@@ -0,0 +1,125 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include "RealtimeFifo.h"
+#include "StoredSample.h"
+
+#include <array>
+#include <atomic>
+#include <functional>
+#include <vector>
+
+// Plays samples for the sample browser without blocking the message thread or the
+// audio thread.
+//
+// audition() and prefetch() only queue a request for the loader thread, which fetches
+// the sample (from the sample cache, decoding only on a miss) and hands it to the audio
+// thread through a lock-free queue of handoff slots. The audio thread swaps the handle
+// into a voice and sends the slot back with whatever the voice held before; finished
+// voices are sent back the same way. The loader thread drops those handles, so any
+// freeing happens there and never in the audio callback.
+//
+// A new audition fades out whatever is still playing, so stepping through a list
+// crossfades from one sample to the next. Prefetched samples are held by the loader
+// thread, which keeps them cached until newer ones push them out.
+class AuditionEngine
+{
+public:
+    static constexpr int kNumVoices = 4;
+    static constexpr int kMaxPrefetched = 8;
+
+    // An encoded audio file in memory. data must stay valid for the engine's lifetime,
+    // as embedded resources do.
+    struct Source
+    {
+        juce::String name;
+        const void* data = nullptr;
+        int sizeBytes = 0;
+    };
+
+    // Fetches source at sampleRate; runs on the loader thread
+    using LoadFunction = std::function<bool (const Source& source, double sampleRate, StoredSample& sample)>;
+
+    explicit AuditionEngine (LoadFunction loadFunction);
+    ~AuditionEngine();
+
+    // Message thread: plays source as soon as it is loaded. A newer call replaces a request
+    // that has not started loading yet.
+    void audition (const Source& source);
+
+    // Message thread: loads sources in the background so auditioning them starts at once.
+    // Replaces any earlier prefetch request.
+    void prefetch (const std::vector<Source>& sources);
+
+    // Any thread: fades out everything playing
+    void stop() noexcept    { stopRequested.store (true, std::memory_order_release); }
+
+    // While the audio callback is stopped. Stops playback; loads in flight at the old rate are dropped.
+    void prepare (double sampleRate);
+
+    // Audio thread: adds the playing voices into buffer
+    void process (juce::AudioBuffer<float>& buffer, int numSamples) noexcept;
+
+    // Audio thread: true while a voice is playing or a loaded sample is waiting to start
+    bool isSounding() const noexcept;
+
+private:
+    class Loader;
+    friend class Loader;
+
+    static constexpr int kNumSlots = 8;
+    static constexpr double kChokeSeconds = 0.01;
+
+    enum VoiceState : int
+    {
+        idle,       // audio thread may start it
+        playing,    // owned by the audio thread
+        released    // finished; the loader thread drops its sample and makes it idle
+    };
+
+    struct Voice
+    {
+        std::atomic<int> state { idle };
+        StoredSample sample;
+        int index = 0;
+        int length = 0;
+        MixKernels::EnvelopeState env;
+        juce::uint32 startOrder = 0;
+    };
+
+    struct Command
+    {
+        int slot = -1;
+        juce::uint32 generation = 0;
+    };
+
+    // Exactly one of slot and voice is set
+    struct Retired
+    {
+        int slot = -1;
+        int voice = -1;
+    };
+
+    void start (const Command& command) noexcept;
+    void choke (Voice& voice) noexcept;
+    void release (int voiceIndex) noexcept;
+
+    LoadFunction load;
+
+    std::array<Voice, (size_t) kNumVoices> voices;
+    std::array<StoredSample, (size_t) kNumSlots> slots;   // loader thread fills, audio thread swaps
+
+    RealtimeEventFifo<Command, kNumSlots + 1> commands;                // loader -> audio
+    RealtimeEventFifo<Retired, kNumSlots + kNumVoices + 1> retired;    // audio -> loader
+
+    std::atomic<double> sampleRate { 44100.0 };
+    std::atomic<juce::uint32> generation { 0 };
+    std::atomic<bool> stopRequested { false };
+    float chokeAlpha = 1.0f;
+    int chokeSamples = 0;
+    juce::uint32 startCounter = 0;
+
+    std::unique_ptr<Loader> loader;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AuditionEngine)
+};
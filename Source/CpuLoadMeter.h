@@ -0,0 +1,143 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <array>
+#include <cstdint>
+
+#include "RealtimeSnapshot.h"
+
+// How much of the real-time budget the audio callback uses. The engine times its stages
+// and each slot with the high-resolution clock into BlockTimes; addBlock() folds every
+// callback into a window of about 100 ms and publishes the window through a
+// RealtimeSnapshot, so the editor and monitoring code read it without locks.
+//
+// Loads are fractions of the audio a block produced: 1.0 means the callback took as long
+// as its samples last, and the host would glitch.
+template <int NumSlots>
+class CpuLoadMeter
+{
+public:
+    enum Section
+    {
+        slotScheduling, // phases, hit gathering and MIDI out for every slot
+        voiceMixing,    // rendering and summing the voices, frozen playback and audition
+        scopeDownmix,   // mono copy for the editor's scope
+        numSections
+    };
+
+    struct Load
+    {
+        float block = 0.0f;        // mean over the window
+        float blockPeak = 0.0f;    // worst single block in the window
+        float worstBlock = 0.0f;   // worst single block since prepare()
+        std::array<float, numSections> sections{};
+        std::array<float, NumSlots> slots{}; // the slot's scheduling plus its share of its render group
+        uint32_t numOverruns = 0;  // blocks since prepare() that took longer than their audio
+        uint32_t windowIndex = 0;  // counts published windows
+    };
+
+    // One block's stage times in high-resolution ticks, filled by the engine
+    struct BlockTimes
+    {
+        std::array<juce::int64, numSections> sections{};
+        std::array<juce::int64, NumSlots> slots{};
+
+        void clear() noexcept
+        {
+            sections.fill (0);
+            slots.fill (0);
+        }
+    };
+
+    static juce::int64 now() noexcept   { return juce::Time::getHighResolutionTicks(); }
+
+    // Call while the audio thread is stopped
+    void prepare (double sampleRate) noexcept
+    {
+        ticksPerSample = sampleRate > 0.0 ? (double) juce::Time::getHighResolutionTicksPerSecond() / sampleRate : 0.0;
+        windowLength = juce::jmax (1, juce::roundToInt (sampleRate * kWindowSeconds));
+        resetWindow();
+        worstBlock = 0.0f;
+        numOverruns = 0;
+    }
+
+    // Audio thread: accounts for one callback. times is null when the engine stages ran
+    // elsewhere, leaving only the callback's own total.
+    void addBlock (juce::int64 blockTicks, int numSamples, const BlockTimes* times) noexcept
+    {
+        if (numSamples <= 0 || ticksPerSample <= 0.0)
+            return;
+
+        const double budget = (double) numSamples * ticksPerSample;
+        const float load = (float) ((double) blockTicks / budget);
+
+        windowTicks += (double) blockTicks;
+        windowBudget += budget;
+        windowPeak = juce::jmax (windowPeak, load);
+        worstBlock = juce::jmax (worstBlock, load);
+        if (load > 1.0f)
+            ++numOverruns;
+
+        if (times != nullptr)
+        {
+            for (size_t s = 0; s < sectionTicks.size(); ++s)
+                sectionTicks[s] += (double) times->sections[s];
+            for (size_t i = 0; i < slotTicks.size(); ++i)
+                slotTicks[i] += (double) times->slots[i];
+        }
+
+        windowSamples += numSamples;
+        if (windowSamples >= windowLength)
+            publishWindow();
+    }
+
+    // The latest window. One reader thread only; in this plugin, the message thread.
+    const Load& getLoad() noexcept      { return published.read(); }
+
+private:
+    static constexpr double kWindowSeconds = 0.1;
+
+    void publishWindow() noexcept
+    {
+        auto& load = published.write();
+        const double scale = 1.0 / windowBudget;
+
+        load.block = (float) (windowTicks * scale);
+        load.blockPeak = windowPeak;
+        load.worstBlock = worstBlock;
+        for (size_t s = 0; s < sectionTicks.size(); ++s)
+            load.sections[s] = (float) (sectionTicks[s] * scale);
+        for (size_t i = 0; i < slotTicks.size(); ++i)
+            load.slots[i] = (float) (slotTicks[i] * scale);
+        load.numOverruns = numOverruns;
+        load.windowIndex = ++windowIndex;
+
+        published.publish();
+        resetWindow();
+    }
+
+    void resetWindow() noexcept
+    {
+        windowTicks = 0.0;
+        windowBudget = 0.0;
+        windowPeak = 0.0f;
+        windowSamples = 0;
+        sectionTicks.fill (0.0);
+        slotTicks.fill (0.0);
+    }
+
+    // audio thread
+    double ticksPerSample = 0.0;
+    int windowLength = 1;
+    int windowSamples = 0;
+    double windowTicks = 0.0;
+    double windowBudget = 0.0;
+    float windowPeak = 0.0f;
+    float worstBlock = 0.0f;
+    uint32_t numOverruns = 0;
+    uint32_t windowIndex = 0;
+    std::array<double, numSections> sectionTicks{};
+    std::array<double, NumSlots> slotTicks{};
+
+    RealtimeSnapshot<Load> published;
+};
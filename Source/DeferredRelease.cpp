@@ -0,0 +1,57 @@
+#include "DeferredRelease.h"
+
+//==============================================================================
+class DeferredReleaseThread::Worker : public juce::Thread
+{
+public:
+    explicit Worker(DeferredReleaseThread& o)
+        : juce::Thread("Deferred release"), owner(o)
+    {
+    }
+
+    void run() override
+    {
+        while (!threadShouldExit())
+        {
+            wait(kPollIntervalMs);
+            owner.collectAll();
+        }
+    }
+
+private:
+    DeferredReleaseThread& owner;
+};
+
+//==============================================================================
+DeferredReleaseThread::DeferredReleaseThread()
+{
+    worker = std::make_unique<Worker>(*this);
+    worker->startThread(juce::Thread::Priority::low);
+}
+
+DeferredReleaseThread::~DeferredReleaseThread()
+{
+    worker->signalThreadShouldExit();
+    worker->notify();
+    worker->stopThread(1000);
+    worker.reset();
+}
+
+void DeferredReleaseThread::add(Client& client)
+{
+    const juce::ScopedLock sl(lock);
+    clients.addIfNotAlreadyThere(&client);
+}
+
+void DeferredReleaseThread::remove(Client& client)
+{
+    const juce::ScopedLock sl(lock);
+    clients.removeFirstMatchingValue(&client);
+}
+
+void DeferredReleaseThread::collectAll() noexcept
+{
+    const juce::ScopedLock sl(lock);
+    for (auto* client : clients)
+        client->collect();
+}
@@ -0,0 +1,143 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <array>
+#include <atomic>
+#include <memory>
+
+// One background thread per host process that destroys whatever the audio threads of
+// every plugin instance have retired. It polls, since waking it would mean signalling
+// from the audio thread.
+class DeferredReleaseThread
+{
+public:
+    static constexpr int kPollIntervalMs = 50;
+
+    // Something holding retired objects; collect() runs on the release thread
+    struct Client
+    {
+        virtual ~Client() = default;
+        virtual void collect() noexcept = 0;
+    };
+
+    DeferredReleaseThread();
+    ~DeferredReleaseThread();
+
+    // Message thread. remove() waits for a collect() of client already under way.
+    void add (Client& client);
+    void remove (Client& client);
+
+private:
+    class Worker;
+    friend class Worker;
+
+    void collectAll() noexcept;
+
+    juce::CriticalSection lock;
+    juce::Array<Client*> clients;
+    std::unique_ptr<Worker> worker;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (DeferredReleaseThread)
+};
+
+// Fixed-capacity queue of objects whose destruction may free memory. The audio thread
+// (or any render thread: retire() is multi-producer) moves them in, and the process's
+// DeferredReleaseThread destroys them, so nothing is freed in the audio callback.
+//
+// Bounded MPMC queue after Vyukov: each cell carries a sequence number that tells its
+// producer and consumer whose turn it is. T must be default constructible, and moving
+// into a moved-from T must neither allocate nor free (true of handles like StoredSample).
+template <typename T, int Capacity>
+class ReleaseQueue : private DeferredReleaseThread::Client
+{
+public:
+    static_assert ((Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+    ReleaseQueue()
+    {
+        for (size_t i = 0; i < cells.size(); ++i)
+            cells[i].sequence.store (i, std::memory_order_relaxed);
+
+        collector->add (*this);
+    }
+
+    ~ReleaseQueue() override
+    {
+        collector->remove (*this);
+        collect();
+    }
+
+    // Any thread: takes object, leaving it empty. Returns false, leaving object as it was,
+    // if the queue is full; the caller then has to release it in place.
+    bool retire (T& object) noexcept
+    {
+        auto pos = enqueuePos.load (std::memory_order_relaxed);
+
+        for (;;)
+        {
+            auto& cell = cells[pos & kMask];
+            const auto sequence = cell.sequence.load (std::memory_order_acquire);
+            const auto diff = (std::ptrdiff_t) sequence - (std::ptrdiff_t) pos;
+
+            if (diff == 0)
+            {
+                if (enqueuePos.compare_exchange_weak (pos, pos + 1, std::memory_order_relaxed))
+                {
+                    cell.object = std::move (object);
+                    cell.sequence.store (pos + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (diff < 0)
+            {
+                overflows.fetch_add (1, std::memory_order_relaxed);
+                return false;
+            }
+            else
+            {
+                pos = enqueuePos.load (std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Times retire() found the queue full
+    int getNumOverflows() const noexcept    { return overflows.load (std::memory_order_relaxed); }
+
+private:
+    static constexpr size_t kMask = (size_t) Capacity - 1;
+
+    struct Cell
+    {
+        std::atomic<size_t> sequence { 0 };
+        T object {};
+    };
+
+    // Only the release thread (or the destructor) consumes
+    void collect() noexcept override
+    {
+        for (;;)
+        {
+            const auto pos = dequeuePos;
+            auto& cell = cells[pos & kMask];
+
+            if (cell.sequence.load (std::memory_order_acquire) != pos + 1)
+                return;
+
+            {
+                T dead (std::move (cell.object));
+            }
+
+            dequeuePos = pos + 1;
+            cell.sequence.store (pos + kMask + 1, std::memory_order_release);
+        }
+    }
+
+    std::array<Cell, (size_t) Capacity> cells;
+    std::atomic<size_t> enqueuePos { 0 };
+    size_t dequeuePos = 0;
+    std::atomic<int> overflows { 0 };
+
+    juce::SharedResourcePointer<DeferredReleaseThread> collector;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ReleaseQueue)
+};
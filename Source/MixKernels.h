@@ -0,0 +1,290 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+ #include <emmintrin.h>
+ #define SLOTMACHINE_MIX_SSE 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__) || defined(_M_ARM64)
+ #include <arm_neon.h>
+ #define SLOTMACHINE_MIX_NEON 1
+#endif
+
+// Voice mix kernels: dst += src * gain * env, with env decaying by alpha each sample.
+//
+// The envelope is a geometric series, so instead of the serial env *= alpha per sample
+// each 4-lane chunk evaluates env * alpha^k directly (k = 0..3) and the chunk start
+// advances by alpha^4. Kernels are specialised at compile time on source channels,
+// destination channels and whether the envelope is moving at all, so the inner loops
+// carry no layout branches. Sources may be 32-bit float or one of the 16-bit storage
+// formats, which are widened to float in registers as they are read. Kept free of JUCE
+// so the benchmark in Tools/ can build it standalone.
+namespace MixKernels
+{
+    struct EnvelopeState
+    {
+        float level = 1.0f;   // gain applied to the next sample
+        float alpha = 1.0f;   // per-sample multiplier
+    };
+
+    // How a voice's source samples are stored. int16 holds raw integer values: the
+    // caller folds its dequantisation scale into the gains.
+    enum class SourceFormat : uint8_t
+    {
+        float32,
+        int16,
+        float16
+    };
+
+    // IEEE 754 half-precision sample
+    struct Float16
+    {
+        uint16_t bits = 0;
+    };
+
+    namespace Half
+    {
+        inline float bitsToFloat (uint32_t bits) noexcept
+        {
+            float f;
+            std::memcpy (&f, &bits, sizeof (f));
+            return f;
+        }
+
+        inline uint32_t floatToBits (float f) noexcept
+        {
+            uint32_t bits;
+            std::memcpy (&bits, &f, sizeof (bits));
+            return bits;
+        }
+
+        // Shifting the exponent and mantissa into float position leaves the value scaled
+        // by 2^-112 (the difference in exponent bias), subnormals included
+        constexpr float kRebias = 5.192296858534828e33f; // 2^112
+
+        inline float toFloat (Float16 h) noexcept
+        {
+            const uint32_t magnitude = ((uint32_t) h.bits & 0x7fffu) << 13;
+            const uint32_t sign = ((uint32_t) h.bits & 0x8000u) << 16;
+            return bitsToFloat (floatToBits (bitsToFloat (magnitude) * kRebias) | sign);
+        }
+
+        // Round to nearest even; out of range values saturate to infinity, NaN stays NaN
+        inline Float16 fromFloat (float value) noexcept
+        {
+            uint32_t f = floatToBits (value);
+            const uint32_t sign = f & 0x80000000u;
+            f ^= sign;
+
+            uint32_t out;
+            if (f >= (143u << 23))                       // >= 65536, inf or NaN
+            {
+                out = f > (255u << 23) ? 0x7e00u : 0x7c00u;
+            }
+            else if (f < (113u << 23))                   // half subnormal or zero
+            {
+                constexpr uint32_t denormMagic = 126u << 23;
+                out = floatToBits (bitsToFloat (f) + bitsToFloat (denormMagic)) - denormMagic;
+            }
+            else
+            {
+                const uint32_t mantissaOdd = (f >> 13) & 1u;
+                f += ((uint32_t) (15 - 127) << 23) + 0xfffu + mantissaOdd;
+                out = f >> 13;
+            }
+
+            return Float16 { (uint16_t) (out | (sign >> 16)) };
+        }
+    }
+
+    namespace detail
+    {
+       #if SLOTMACHINE_MIX_SSE
+        using Vec = __m128;
+        inline Vec load  (const float* p) noexcept       { return _mm_loadu_ps (p); }
+        inline void store (float* p, Vec v) noexcept     { _mm_storeu_ps (p, v); }
+        inline Vec splat (float v) noexcept              { return _mm_set1_ps (v); }
+        inline Vec set4  (float a, float b, float c, float d) noexcept { return _mm_setr_ps (a, b, c, d); }
+        inline Vec mul   (Vec a, Vec b) noexcept         { return _mm_mul_ps (a, b); }
+        inline Vec madd  (Vec acc, Vec a, Vec b) noexcept{ return _mm_add_ps (acc, _mm_mul_ps (a, b)); }
+
+        inline Vec load (const int16_t* p) noexcept
+        {
+            const __m128i words = _mm_loadl_epi64 (reinterpret_cast<const __m128i*> (p));
+            return _mm_cvtepi32_ps (_mm_srai_epi32 (_mm_unpacklo_epi16 (words, words), 16));
+        }
+
+        inline Vec load (const Float16* p) noexcept
+        {
+            const __m128i words = _mm_unpacklo_epi16 (_mm_loadl_epi64 (reinterpret_cast<const __m128i*> (p)),
+                                                      _mm_setzero_si128());
+            const __m128i magnitude = _mm_slli_epi32 (_mm_and_si128 (words, _mm_set1_epi32 (0x7fff)), 13);
+            const __m128i sign = _mm_slli_epi32 (_mm_and_si128 (words, _mm_set1_epi32 (0x8000)), 16);
+            return _mm_or_ps (_mm_mul_ps (_mm_castsi128_ps (magnitude), _mm_set1_ps (Half::kRebias)),
+                              _mm_castsi128_ps (sign));
+        }
+        constexpr int kLanes = 4;
+       #elif SLOTMACHINE_MIX_NEON
+        using Vec = float32x4_t;
+        inline Vec load  (const float* p) noexcept       { return vld1q_f32 (p); }
+        inline void store (float* p, Vec v) noexcept     { vst1q_f32 (p, v); }
+        inline Vec splat (float v) noexcept              { return vdupq_n_f32 (v); }
+        inline Vec set4  (float a, float b, float c, float d) noexcept
+        {
+            const float lanes[4] = { a, b, c, d };
+            return vld1q_f32 (lanes);
+        }
+        inline Vec mul   (Vec a, Vec b) noexcept         { return vmulq_f32 (a, b); }
+        inline Vec madd  (Vec acc, Vec a, Vec b) noexcept{ return vmlaq_f32 (acc, a, b); }
+
+        inline Vec load (const int16_t* p) noexcept
+        {
+            return vcvtq_f32_s32 (vmovl_s16 (vld1_s16 (p)));
+        }
+
+        inline Vec load (const Float16* p) noexcept
+        {
+            const uint32x4_t words = vmovl_u16 (vld1_u16 (reinterpret_cast<const uint16_t*> (p)));
+            const uint32x4_t magnitude = vshlq_n_u32 (vandq_u32 (words, vdupq_n_u32 (0x7fff)), 13);
+            const uint32x4_t sign = vshlq_n_u32 (vandq_u32 (words, vdupq_n_u32 (0x8000)), 16);
+            const Vec scaled = vmulq_f32 (vreinterpretq_f32_u32 (magnitude), vdupq_n_f32 (Half::kRebias));
+            return vreinterpretq_f32_u32 (vorrq_u32 (vreinterpretq_u32_f32 (scaled), sign));
+        }
+        constexpr int kLanes = 4;
+       #else
+        constexpr int kLanes = 1;
+       #endif
+
+        inline float toFloat (float v) noexcept     { return v; }
+        inline float toFloat (int16_t v) noexcept   { return (float) v; }
+        inline float toFloat (Float16 v) noexcept   { return Half::toFloat (v); }
+
+        template <typename Sample>
+        inline const Sample* channelAt (const void* channel, int index) noexcept
+        {
+            return channel != nullptr ? static_cast<const Sample*> (channel) + index : nullptr;
+        }
+    }
+
+    // NumSrc: 1 or 2 source channels. NumDst: 1 or 2 destination channels; a mono
+    // destination takes only the left source channel scaled by gainL.
+    // UseEnvelope == false treats env.level as a constant gain (alpha == 1).
+    template <int NumSrc, int NumDst, bool UseEnvelope, typename Sample>
+    inline void mix (const Sample* srcL, const Sample* srcR,
+                     float* dstL, float* dstR,
+                     int numSamples, float gainL, float gainR,
+                     EnvelopeState& env) noexcept
+    {
+        static_assert (NumSrc == 1 || NumSrc == 2, "Source must be mono or stereo");
+        static_assert (NumDst == 1 || NumDst == 2, "Destination must be mono or stereo");
+
+        if (NumSrc == 1 || NumDst == 1)
+            srcR = srcL;
+
+        float level = env.level;
+        int i = 0;
+
+       #if SLOTMACHINE_MIX_SSE || SLOTMACHINE_MIX_NEON
+        using namespace detail;
+
+        if (numSamples >= kLanes)
+        {
+            const float a = env.alpha;
+            const float a2 = a * a;
+            const Vec gL = splat (gainL);
+            const Vec gR = splat (gainR);
+            const Vec powers = set4 (1.0f, a, a2, a2 * a);
+            const float step = UseEnvelope ? a2 * a2 : 1.0f;
+
+            for (; i + kLanes <= numSamples; i += kLanes)
+            {
+                const Vec e = UseEnvelope ? mul (splat (level), powers) : splat (level);
+                const Vec l = load (srcL + i);
+
+                store (dstL + i, madd (load (dstL + i), l, mul (gL, e)));
+
+                if (NumDst == 2)
+                {
+                    const Vec r = NumSrc == 2 ? load (srcR + i) : l;
+                    store (dstR + i, madd (load (dstR + i), r, mul (gR, e)));
+                }
+
+                level *= step;
+            }
+        }
+       #endif
+
+        for (; i < numSamples; ++i)
+        {
+            dstL[i] += detail::toFloat (srcL[i]) * gainL * level;
+
+            if (NumDst == 2)
+                dstR[i] += detail::toFloat (srcR[i]) * gainR * level;
+
+            if (UseEnvelope)
+                level *= env.alpha;
+        }
+
+        env.level = level;
+    }
+
+    // Picks the specialisation for a runtime layout. srcR / dstR may be null for mono.
+    template <typename Sample>
+    inline void mixVoice (const Sample* srcL, const Sample* srcR,
+                          float* dstL, float* dstR,
+                          int numSamples, float gainL, float gainR,
+                          EnvelopeState& env) noexcept
+    {
+        if (srcL == nullptr || dstL == nullptr || numSamples <= 0)
+            return;
+
+        const bool decaying = env.alpha != 1.0f;
+
+        if (dstR == nullptr)
+        {
+            if (decaying) mix<1, 1, true>  (srcL, srcR, dstL, dstR, numSamples, gainL, gainR, env);
+            else          mix<1, 1, false> (srcL, srcR, dstL, dstR, numSamples, gainL, gainR, env);
+        }
+        else if (srcR == nullptr)
+        {
+            if (decaying) mix<1, 2, true>  (srcL, srcR, dstL, dstR, numSamples, gainL, gainR, env);
+            else          mix<1, 2, false> (srcL, srcR, dstL, dstR, numSamples, gainL, gainR, env);
+        }
+        else
+        {
+            if (decaying) mix<2, 2, true>  (srcL, srcR, dstL, dstR, numSamples, gainL, gainR, env);
+            else          mix<2, 2, false> (srcL, srcR, dstL, dstR, numSamples, gainL, gainR, env);
+        }
+    }
+
+    // As mixVoice, for a source whose format is only known at run time. srcL / srcR point
+    // at the start of the stored channels and index is the first sample to read.
+    inline void mixSource (SourceFormat format, const void* srcL, const void* srcR, int index,
+                           float* dstL, float* dstR,
+                           int numSamples, float gainL, float gainR,
+                           EnvelopeState& env) noexcept
+    {
+        using detail::channelAt;
+
+        switch (format)
+        {
+            case SourceFormat::int16:
+                mixVoice (channelAt<int16_t> (srcL, index), channelAt<int16_t> (srcR, index),
+                          dstL, dstR, numSamples, gainL, gainR, env);
+                break;
+
+            case SourceFormat::float16:
+                mixVoice (channelAt<Float16> (srcL, index), channelAt<Float16> (srcR, index),
+                          dstL, dstR, numSamples, gainL, gainR, env);
+                break;
+
+            case SourceFormat::float32:
+            default:
+                mixVoice (channelAt<float> (srcL, index), channelAt<float> (srcR, index),
+                          dstL, dstR, numSamples, gainL, gainR, env);
+                break;
+        }
+    }
+}
@@ -298,6 +298,37 @@ namespace
         juce::ImageComponent logoComponent;
         juce::Label aboutLabel;
     };
+
+    // Tooltip for a slot's file label: level and how much silence was trimmed on load
+    juce::String describeSampleAnalysis(const SampleAnalysis& analysis)
+    {
+        if (analysis.sourceLength <= 0)
+            return {};
+
+        if (analysis.silent)
+            return "Silent sample";
+
+        auto ms = [&analysis](int samples) { return juce::String(analysis.samplesToMs(samples), 1) + " ms"; };
+
+        return "Length " + ms(analysis.getContentLength())
+            + "\nPeak " + juce::String(juce::Decibels::gainToDecibels(analysis.peak), 1) + " dB"
+            + ", RMS " + juce::String(juce::Decibels::gainToDecibels(analysis.rms), 1) + " dB"
+            + "\nTrimmed " + ms(analysis.getLeadingTrim()) + " before the attack, "
+            + ms(analysis.getTrailingTrim()) + " after the end";
+    }
+
+    juce::String describeSampleMemory(const SampleMemoryManager::Usage& usage)
+    {
+        auto mb = [](size_t bytes) { return juce::String((double)bytes / (1024.0 * 1024.0), 1) + " MB"; };
+
+        juce::String text = mb(usage.residentBytes) + " of " + mb(usage.budgetBytes) + " in memory ("
+            + mb(usage.inUseBytes) + " playing, " + mb(usage.residentBytes - usage.inUseBytes) + " cached)";
+
+        if (usage.mappedBytes > 0)
+            text << ", " << mb(usage.mappedBytes) << " streamed from disk";
+
+        return text;
+    }
 }
 
 // ===== PatternTabs =====
@@ -721,6 +752,95 @@ void SlotMachineAudioProcessorEditor::RenamePatternComponent::commit(bool accept
     }
 }
 
+void SlotMachineAudioProcessorEditor::CpuMeter::update(const SlotMachineAudioProcessor::CpuLoad& load)
+{
+    if (load.windowIndex == lastWindowIndex)
+        return;
+
+    lastWindowIndex = load.windowIndex;
+    meanLoad = load.block;
+    peakHistory[(size_t)historyWritePos] = load.blockPeak;
+    historyWritePos = (historyWritePos + 1) % kHistoryLength;
+
+    using Meter = CpuLoadMeter<SlotMachineAudioProcessor::kNumSlots>;
+    auto percent = [](float value) { return juce::String(100.0f * value, 1) + "%"; };
+
+    int busiestSlot = 0;
+    for (int i = 1; i < (int)load.slots.size(); ++i)
+        if (load.slots[(size_t)i] > load.slots[(size_t)busiestSlot])
+            busiestSlot = i;
+
+    setTooltip("Audio thread load (share of each block's duration)\n"
+               "Mean " + percent(load.block) + ", worst block " + percent(load.blockPeak) + "\n"
+               "Slot scheduling " + percent(load.sections[Meter::slotScheduling])
+               + ", voice mixing " + percent(load.sections[Meter::voiceMixing])
+               + ", scope " + percent(load.sections[Meter::scopeDownmix]) + "\n"
+               "Busiest slot " + juce::String(busiestSlot + 1) + ": " + percent(load.slots[(size_t)busiestSlot]) + "\n"
+               "Worst block since start " + percent(load.worstBlock)
+               + ", overruns " + juce::String((int)load.numOverruns) + "\n"
+               "Click to record or save an engine trace");
+    repaint();
+}
+
+void SlotMachineAudioProcessorEditor::CpuMeter::paint(juce::Graphics& g)
+{
+    auto bounds = getLocalBounds().toFloat();
+    g.setColour(juce::Colours::black.withAlpha(0.35f));
+    g.fillRoundedRectangle(bounds, 6.0f);
+    g.setColour(juce::Colours::white.withAlpha(0.12f));
+    g.drawRoundedRectangle(bounds, 6.0f, 1.2f);
+
+    auto inner = bounds.reduced(6.0f, 4.0f);
+    auto textArea = inner.removeFromLeft(juce::jmin(70.0f, inner.getWidth() * 0.5f));
+    auto barArea = inner.removeFromBottom(5.0f);
+    auto historyArea = inner.withTrimmedBottom(2.0f);
+
+    auto colourFor = [](float load)
+    {
+        if (load >= 0.9f) return juce::Colours::red.withAlpha(0.85f);
+        if (load >= 0.6f) return juce::Colours::orange.withAlpha(0.85f);
+        return juce::Colours::white.withAlpha(0.6f);
+    };
+
+    // Worst block of each window, oldest on the left, scaled so a full column is the whole budget
+    float heldPeak = 0.0f;
+    const float columnWidth = historyArea.getWidth() / (float)kHistoryLength;
+    for (int n = 0; n < kHistoryLength; ++n)
+    {
+        const float peak = peakHistory[(size_t)((historyWritePos + n) % kHistoryLength)];
+        heldPeak = juce::jmax(heldPeak, peak);
+
+        const float h = historyArea.getHeight() * juce::jlimit(0.0f, 1.0f, peak);
+        if (h < 0.5f)
+            continue;
+
+        g.setColour(colourFor(peak));
+        g.fillRect(historyArea.getX() + (float)n * columnWidth, historyArea.getBottom() - h,
+                   juce::jmax(1.0f, columnWidth - 0.5f), h);
+    }
+
+    g.setColour(juce::Colours::white.withAlpha(0.18f));
+    g.fillRoundedRectangle(barArea, 2.0f);
+    g.setColour(colourFor(meanLoad));
+    g.fillRoundedRectangle(barArea.withWidth(barArea.getWidth() * juce::jlimit(0.0f, 1.0f, meanLoad)), 2.0f);
+
+    const float holdX = barArea.getX() + barArea.getWidth() * juce::jlimit(0.0f, 1.0f, heldPeak);
+    g.setColour(colourFor(heldPeak));
+    g.drawLine(holdX, barArea.getY() - 2.0f, holdX, barArea.getBottom() + 1.0f, 1.5f);
+
+    g.setFont(createBoldFont(12.0f));
+    g.setColour(juce::Colours::white.withAlpha(0.85f));
+    g.drawFittedText("CPU " + juce::String(juce::roundToInt(100.0f * meanLoad)) + "%\n"
+                     "pk " + juce::String(juce::roundToInt(100.0f * heldPeak)) + "%",
+                     textArea.toNearestInt(), juce::Justification::centredLeft, 2);
+}
+
+void SlotMachineAudioProcessorEditor::CpuMeter::mouseUp(const juce::MouseEvent& e)
+{
+    if (onMenuRequested && (e.mods.isPopupMenu() || e.mouseWasClicked()))
+        onMenuRequested();
+}
+
 // ===== Font helpers =====
 static juce::Font createBoldFont(float size)
 {
@@ -751,6 +871,10 @@ class SlotMachineAudioProcessorEditor::EmbeddedSampleSelector : public juce::Com
 public:
     EmbeddedSampleSelector(const EmbeddedCatalog& catalog)
     {
+        for (const auto& entry : catalog)
+            for (const auto& sample : entry.second)
+                resourceOrder.add(sample.resourceName);
+
         content = std::make_unique<ListContent>(*this, catalog);
         viewport.setViewedComponent(content.get(), false);
         viewport.setScrollBarsShown(true, false);
@@ -767,6 +891,7 @@ public:
 
     std::function<void(const juce::String&)> onPick;
     std::function<void(const juce::String&)> onPreview;
+    std::function<void(const juce::StringArray&)> onPrefetch;
 
     void resized() override
     {
@@ -781,6 +906,26 @@ public:
     }
 
 private:
+    // Asks for resource and the rows around it in list order to be loaded ahead of an audition
+    void prefetchAround(const juce::String& resource, int radius)
+    {
+        const int index = resourceOrder.indexOf(resource);
+        if (index < 0 || !onPrefetch)
+            return;
+
+        // Nearest first, so the likeliest next audition is ready soonest
+        juce::StringArray names{ resource };
+        for (int step = 1; step <= radius; ++step)
+        {
+            if (index + step < resourceOrder.size())
+                names.add(resourceOrder[index + step]);
+            if (index - step >= 0)
+                names.add(resourceOrder[index - step]);
+        }
+
+        onPrefetch(names);
+    }
+
     class SpeakerButton : public juce::Button
     {
     public:
@@ -904,7 +1049,17 @@ private:
                 {
                     if (owner.onPreview)
                         owner.onPreview(resource);
+
+                    owner.prefetchAround(resource, 2);
                 };
+
+                // Hovering over any part of the row gets its sample loading before the click
+                addMouseListener(this, true);
+            }
+
+            void mouseEnter(const juce::MouseEvent&) override
+            {
+                owner.prefetchAround(resource, 1);
             }
 
             void resized() override
@@ -986,6 +1141,7 @@ private:
 
     juce::Viewport viewport;
     std::unique_ptr<ListContent> content;
+    juce::StringArray resourceOrder;
 };
 
 SlotMachineAudioProcessorEditor::SlotUI::FileButton::FileButton()
@@ -1163,10 +1319,12 @@ void SlotMachineAudioProcessorEditor::openEmbeddedSampleSelectorForSlot(int slot
 
     selector->onPreview = [this](const juce::String& resource)
     {
-        int size = 0;
-        const void* bytes = BinaryData::getNamedResource(resource.toRawUTF8(), size);
-        if (bytes != nullptr && size > 0)
-            processor.previewEmbeddedWav(bytes, size);
+        processor.previewEmbeddedWav(resource);
+    };
+
+    selector->onPrefetch = [this](const juce::StringArray& resources)
+    {
+        processor.prefetchEmbeddedWavs(resources);
     };
 
     selector->onPick = [this, slotIndex](const juce::String& resource)
@@ -1226,7 +1384,8 @@ void SlotMachineAudioProcessorEditor::SlotUI::updateTimingModeVisibility(int tim
 // ===== Standalone persistence for Options =====
 static const juce::StringArray kOptionParamIds{
     "optShowMasterBar", "optShowSlotBars", "optShowVisualizer", "optVisualizerEdgeWalk",
-    "optSampleRate", "optTimingMode",
+    "optSampleRate", "optTimingMode", "optMidiVelocity", "optMidiGateMs", "optClickQuantise",
+    "optParallelRender", "optFreezePatterns", "optRenderAhead", "optSampleStorage", "optSampleMemoryMB",
     "optSlotScale",
     "optGlowColor", "optGlowAlpha", "optGlowWidth",
     "optPulseColor", "optPulseAlpha", "optPulseWidth"
@@ -1405,11 +1564,13 @@ namespace
 class OptionsComponent : public juce::Component,
     private juce::Button::Listener,
     private juce::ChangeListener,
-    private juce::Slider::Listener
+    private juce::Slider::Listener,
+    private juce::Timer
 {
 public:
-    explicit OptionsComponent(APVTS& s, std::function<void(float)> slotScaleChangedCallback = {})
-        : apvts(s), slotScaleChanged(slotScaleChangedCallback)
+    explicit OptionsComponent(APVTS& s, std::function<void(float)> slotScaleChangedCallback = {},
+        std::function<juce::String()> sampleMemoryTextCallback = {})
+        : apvts(s), slotScaleChanged(slotScaleChangedCallback), sampleMemoryText(sampleMemoryTextCallback)
     {
         // toggles
         addAndMakeVisible(showMasterBar);
@@ -1460,6 +1621,85 @@ public:
         timingModeCombo.addItem("Count (Beats/Cycle)", 2);
         timingModeCombo.onChange = [this]() { handleTimingModeSelection(); };
 
+        // MIDI input velocity sensitivity
+        midiVelocityLabel.setText("MIDI In Velocity Sensitivity", juce::dontSendNotification);
+        midiVelocityLabel.setColour(juce::Label::textColourId, juce::Colours::white);
+        addAndMakeVisible(midiVelocityLabel);
+
+        addAndMakeVisible(midiVelocityCombo);
+        midiVelocityCombo.setJustificationType(juce::Justification::centredLeft);
+        for (int i = 0; i < (int)midiVelocityValues.size(); ++i)
+        {
+            const int value = midiVelocityValues[(size_t)i];
+            midiVelocityCombo.addItem(value == 0 ? juce::String("Off (fixed gain)") : juce::String(value) + "%", i + 1);
+        }
+        midiVelocityCombo.onChange = [this]() { handleMidiVelocitySelection(); };
+
+        // MIDI output note length
+        midiGateLabel.setText("MIDI Out Note Length", juce::dontSendNotification);
+        midiGateLabel.setColour(juce::Label::textColourId, juce::Colours::white);
+        addAndMakeVisible(midiGateLabel);
+
+        addAndMakeVisible(midiGateCombo);
+        midiGateCombo.setJustificationType(juce::Justification::centredLeft);
+        for (int i = 0; i < (int)midiGateValues.size(); ++i)
+            midiGateCombo.addItem(juce::String(juce::roundToInt(midiGateValues[(size_t)i])) + " ms", i + 1);
+        midiGateCombo.onChange = [this]() { handleMidiGateSelection(); };
+
+        // sample storage format
+        sampleStorageLabel.setText("Sample Storage", juce::dontSendNotification);
+        sampleStorageLabel.setColour(juce::Label::textColourId, juce::Colours::white);
+        addAndMakeVisible(sampleStorageLabel);
+
+        addAndMakeVisible(sampleStorageCombo);
+        sampleStorageCombo.setJustificationType(juce::Justification::centredLeft);
+        sampleStorageCombo.addItem("32-bit float", 1);
+        sampleStorageCombo.addItem("16-bit integer (half memory)", 2);
+        sampleStorageCombo.addItem("16-bit float (half memory)", 3);
+        sampleStorageCombo.setTooltip("How samples are held in memory. Applies to samples loaded from now on.");
+        sampleStorageCombo.onChange = [this]() { handleSampleStorageSelection(); };
+
+        // sample memory budget and current usage
+        sampleMemoryLabel.setText("Sample Memory Budget", juce::dontSendNotification);
+        sampleMemoryLabel.setColour(juce::Label::textColourId, juce::Colours::white);
+        addAndMakeVisible(sampleMemoryLabel);
+
+        addAndMakeVisible(sampleMemoryCombo);
+        sampleMemoryCombo.setJustificationType(juce::Justification::centredLeft);
+        for (int i = 0; i < (int)sampleMemoryValues.size(); ++i)
+        {
+            const int value = sampleMemoryValues[(size_t)i];
+            sampleMemoryCombo.addItem(value >= 1024 ? juce::String(value / 1024) + " GB" : juce::String(value) + " MB", i + 1);
+        }
+        sampleMemoryCombo.setTooltip("Shared by every instance of the plugin in this host. Unused samples are "
+                                     "dropped from memory, oldest first, beyond this. Very large samples stream from disk instead.");
+        sampleMemoryCombo.onChange = [this]() { handleSampleMemorySelection(); };
+
+        sampleMemoryUsage.setColour(juce::Label::textColourId, juce::Colours::lightgrey);
+        sampleMemoryUsage.setJustificationType(juce::Justification::centredLeft);
+        addAndMakeVisible(sampleMemoryUsage);
+
+        addAndMakeVisible(quantiseClicks);
+        quantiseClicks.setButtonText("Quantise slot clicks to the slot grid");
+        quantiseClicks.addListener(this);
+
+        addAndMakeVisible(parallelRender);
+        parallelRender.setButtonText("Multi-core slot rendering");
+        parallelRender.setTooltip("Spread heavy sessions over several CPU cores (takes effect at large buffer sizes)");
+        parallelRender.addListener(this);
+
+        addAndMakeVisible(freezePatterns);
+        freezePatterns.setButtonText("Freeze static patterns");
+        freezePatterns.setTooltip("Loop one captured cycle while nothing changes, instead of mixing every voice. "
+                                  "Saves the voice mixing; hit scheduling and MIDI still run. "
+                                  "Uses up to 10 s of stereo audio memory. Applies when the host restarts audio.");
+        freezePatterns.addListener(this);
+
+        addAndMakeVisible(renderAhead);
+        renderAhead.setButtonText("Render ahead (adds latency)");
+        renderAhead.setTooltip("Render a few milliseconds ahead on a background thread, for very small host buffers. Applies when the host restarts audio.");
+        renderAhead.addListener(this);
+
         // slot scale
         slotScaleLabel.setText("Slot Row Density", juce::dontSendNotification);
         slotScaleLabel.setColour(juce::Label::textColourId, juce::Colours::white);
@@ -1526,6 +1766,9 @@ public:
         btnClose.addListener(this);
 
         refreshFromState();
+
+        if (sampleMemoryText)
+            startTimer(1000);
     }
 
     void resized() override
@@ -1552,6 +1795,31 @@ public:
         timingModeLabel.setBounds(timingRow.removeFromLeft(getWidth() / 2 - 16));
         timingModeCombo.setBounds(timingRow.removeFromLeft(220).reduced(0, 8));
 
+        auto midiVelocityRow = a.removeFromTop(48);
+        midiVelocityLabel.setBounds(midiVelocityRow.removeFromLeft(getWidth() / 2 - 16));
+        midiVelocityCombo.setBounds(midiVelocityRow.removeFromLeft(180).reduced(0, 8));
+
+        auto midiGateRow = a.removeFromTop(48);
+        midiGateLabel.setBounds(midiGateRow.removeFromLeft(getWidth() / 2 - 16));
+        midiGateCombo.setBounds(midiGateRow.removeFromLeft(180).reduced(0, 8));
+
+        auto sampleStorageRow = a.removeFromTop(48);
+        sampleStorageLabel.setBounds(sampleStorageRow.removeFromLeft(getWidth() / 2 - 16));
+        sampleStorageCombo.setBounds(sampleStorageRow.removeFromLeft(240).reduced(0, 8));
+
+        auto sampleMemoryRow = a.removeFromTop(48);
+        sampleMemoryLabel.setBounds(sampleMemoryRow.removeFromLeft(getWidth() / 2 - 16));
+        sampleMemoryCombo.setBounds(sampleMemoryRow.removeFromLeft(180).reduced(0, 8));
+        sampleMemoryUsage.setBounds(a.removeFromTop(24));
+
+        auto quantiseRow = a.removeFromTop(36);
+        quantiseClicks.setBounds(quantiseRow.removeFromLeft(getWidth() / 2 - 16).reduced(0, 4));
+        parallelRender.setBounds(quantiseRow.reduced(0, 4));
+
+        auto engineRow = a.removeFromTop(36);
+        freezePatterns.setBounds(engineRow.removeFromLeft(getWidth() / 2 - 16).reduced(0, 4));
+        renderAhead.setBounds(engineRow.reduced(0, 4));
+
         auto scaleRow = a.removeFromTop(48);
         slotScaleLabel.setBounds(scaleRow.removeFromLeft(getWidth() / 2 - 16));
         slotScaleCombo.setBounds(scaleRow.removeFromLeft(180).reduced(0, 8));
@@ -1605,6 +1873,19 @@ private:
     juce::ComboBox sampleRateCombo;
     juce::Label timingModeLabel;
     juce::ComboBox timingModeCombo;
+    juce::Label midiVelocityLabel;
+    juce::ComboBox midiVelocityCombo;
+    juce::Label midiGateLabel;
+    juce::ComboBox midiGateCombo;
+    juce::Label sampleStorageLabel;
+    juce::ComboBox sampleStorageCombo;
+    juce::Label sampleMemoryLabel;
+    juce::ComboBox sampleMemoryCombo;
+    juce::Label sampleMemoryUsage;
+    juce::ToggleButton quantiseClicks;
+    juce::ToggleButton parallelRender;
+    juce::ToggleButton freezePatterns;
+    juce::ToggleButton renderAhead;
 
     juce::Label slotScaleLabel;
     juce::ComboBox slotScaleCombo;
@@ -1630,10 +1911,18 @@ private:
     static constexpr int sliderVerticalPadding = 8;
 
     std::function<void(float)> slotScaleChanged;
+    std::function<juce::String()> sampleMemoryText;
     std::array<int, 2>   sampleRateValues{ { 48000, 44100 } };
     std::array<int, 2>   timingModeValues{ { 0, 1 } };
     bool blockSampleRateUpdate = false;
     bool blockTimingModeUpdate = false;
+    std::array<int, 3>   midiVelocityValues{ { 100, 50, 0 } };
+    bool blockMidiVelocityUpdate = false;
+    std::array<float, 5> midiGateValues{ { 10.0f, 25.0f, 50.0f, 100.0f, 250.0f } };
+    bool blockMidiGateUpdate = false;
+    bool blockSampleStorageUpdate = false;
+    std::array<int, 6>   sampleMemoryValues{ { 256, 512, 1024, 2048, 4096, 8192 } };
+    bool blockSampleMemoryUpdate = false;
     bool blockVisualizerModeUpdate = false;
     std::array<float, 6> slotScaleValues{ { 0.75f, 0.8f, 0.85f, 0.9f, 0.95f, 1.0f } };
     bool blockSlotScaleUpdate = false;
@@ -1677,6 +1966,10 @@ private:
         showMasterBar.setToggleState(Opt::getBool(apvts, "optShowMasterBar", true), juce::dontSendNotification);
         showSlotBars.setToggleState(Opt::getBool(apvts, "optShowSlotBars", true), juce::dontSendNotification);
         showVisualizer.setToggleState(Opt::getBool(apvts, "optShowVisualizer", false), juce::dontSendNotification);
+        quantiseClicks.setToggleState(Opt::getBool(apvts, "optClickQuantise", false), juce::dontSendNotification);
+        parallelRender.setToggleState(Opt::getBool(apvts, "optParallelRender", false), juce::dontSendNotification);
+        freezePatterns.setToggleState(Opt::getBool(apvts, "optFreezePatterns", false), juce::dontSendNotification);
+        renderAhead.setToggleState(Opt::getBool(apvts, "optRenderAhead", false), juce::dontSendNotification);
 
         const bool edgeWalk = Opt::getBool(apvts, "optVisualizerEdgeWalk", true);
         blockVisualizerModeUpdate = true;
@@ -1715,6 +2008,62 @@ private:
         timingModeCombo.setSelectedId(timingModeId, juce::dontSendNotification);
         blockTimingModeUpdate = false;
 
+        const int midiVelocityValue = Opt::getInt(apvts, "optMidiVelocity", midiVelocityValues.front());
+        int midiVelocityId = 1;
+        int bestVelocityDiff = std::numeric_limits<int>::max();
+        for (int i = 0; i < (int)midiVelocityValues.size(); ++i)
+        {
+            const int diff = std::abs(midiVelocityValues[(size_t)i] - midiVelocityValue);
+            if (diff < bestVelocityDiff)
+            {
+                bestVelocityDiff = diff;
+                midiVelocityId = i + 1;
+            }
+        }
+
+        blockMidiVelocityUpdate = true;
+        midiVelocityCombo.setSelectedId(midiVelocityId, juce::dontSendNotification);
+        blockMidiVelocityUpdate = false;
+
+        const float midiGateValue = Opt::getFloat(apvts, "optMidiGateMs", midiGateValues.front());
+        int midiGateId = 1;
+        float bestGateDiff = std::numeric_limits<float>::max();
+        for (int i = 0; i < (int)midiGateValues.size(); ++i)
+        {
+            const float diff = std::abs(midiGateValues[(size_t)i] - midiGateValue);
+            if (diff < bestGateDiff)
+            {
+                bestGateDiff = diff;
+                midiGateId = i + 1;
+            }
+        }
+
+        blockMidiGateUpdate = true;
+        midiGateCombo.setSelectedId(midiGateId, juce::dontSendNotification);
+        blockMidiGateUpdate = false;
+
+        blockSampleStorageUpdate = true;
+        sampleStorageCombo.setSelectedId(juce::jlimit(0, 2, Opt::getInt(apvts, "optSampleStorage", 0)) + 1, juce::dontSendNotification);
+        blockSampleStorageUpdate = false;
+
+        const int sampleMemoryValue = Opt::getInt(apvts, "optSampleMemoryMB", 1024);
+        int sampleMemoryId = 1;
+        int bestMemoryDiff = std::numeric_limits<int>::max();
+        for (int i = 0; i < (int)sampleMemoryValues.size(); ++i)
+        {
+            const int diff = std::abs(sampleMemoryValues[(size_t)i] - sampleMemoryValue);
+            if (diff < bestMemoryDiff)
+            {
+                bestMemoryDiff = diff;
+                sampleMemoryId = i + 1;
+            }
+        }
+
+        blockSampleMemoryUpdate = true;
+        sampleMemoryCombo.setSelectedId(sampleMemoryId, juce::dontSendNotification);
+        blockSampleMemoryUpdate = false;
+        refreshSampleMemoryUsage();
+
         const float currentScale = Opt::getFloat(apvts, "optSlotScale", 0.8f);
         int bestId = 1;
         float bestDiff = std::numeric_limits<float>::max();
@@ -1752,6 +2101,14 @@ private:
             setBoolParam("optShowSlotBars", showSlotBars.getToggleState());
         else if (b == &showVisualizer)
             setBoolParam("optShowVisualizer", showVisualizer.getToggleState());
+        else if (b == &quantiseClicks)
+            setBoolParam("optClickQuantise", quantiseClicks.getToggleState());
+        else if (b == &parallelRender)
+            setBoolParam("optParallelRender", parallelRender.getToggleState());
+        else if (b == &freezePatterns)
+            setBoolParam("optFreezePatterns", freezePatterns.getToggleState());
+        else if (b == &renderAhead)
+            setBoolParam("optRenderAhead", renderAhead.getToggleState());
         else if (b == &btnResetDefaults)
             resetToDefaultOptions();
         else if (b == &btnClose)
@@ -1838,6 +2195,66 @@ private:
         applyVisualizerAvailabilityForTimingMode(value);
     }
 
+    void handleMidiVelocitySelection()
+    {
+        if (blockMidiVelocityUpdate)
+            return;
+
+        const int id = midiVelocityCombo.getSelectedId();
+        if (id <= 0 || id > (int)midiVelocityValues.size())
+            return;
+
+        setIntParam("optMidiVelocity", midiVelocityValues[(size_t)(id - 1)]);
+    }
+
+    void handleMidiGateSelection()
+    {
+        if (blockMidiGateUpdate)
+            return;
+
+        const int id = midiGateCombo.getSelectedId();
+        if (id <= 0 || id > (int)midiGateValues.size())
+            return;
+
+        setFloatParam("optMidiGateMs", midiGateValues[(size_t)(id - 1)]);
+    }
+
+    void handleSampleStorageSelection()
+    {
+        if (blockSampleStorageUpdate)
+            return;
+
+        const int id = sampleStorageCombo.getSelectedId();
+        if (id <= 0 || id > 3)
+            return;
+
+        setIntParam("optSampleStorage", id - 1);
+    }
+
+    void handleSampleMemorySelection()
+    {
+        if (blockSampleMemoryUpdate)
+            return;
+
+        const int id = sampleMemoryCombo.getSelectedId();
+        if (id <= 0 || id > (int)sampleMemoryValues.size())
+            return;
+
+        setIntParam("optSampleMemoryMB", sampleMemoryValues[(size_t)(id - 1)]);
+        refreshSampleMemoryUsage();
+    }
+
+    void refreshSampleMemoryUsage()
+    {
+        if (sampleMemoryText)
+            sampleMemoryUsage.setText(sampleMemoryText(), juce::dontSendNotification);
+    }
+
+    void timerCallback() override
+    {
+        refreshSampleMemoryUsage();
+    }
+
     void resetToDefaultOptions()
     {
         constexpr float kDefaultSlotScale = 0.80f;
@@ -1849,6 +2266,9 @@ private:
         constexpr float kDefaultPulseWidth = 4.0f;
         constexpr int   kDefaultSampleRate = 48000;
         constexpr int   kDefaultTimingMode = 0;
+        constexpr int   kDefaultMidiVelocity = 100;
+        constexpr float kDefaultMidiGateMs = 10.0f;
+        constexpr int   kDefaultSampleMemoryMB = 1024;
 
         setBoolParam("optShowMasterBar", true);
         setBoolParam("optShowSlotBars", true);
@@ -1856,6 +2276,14 @@ private:
         setBoolParam("optVisualizerEdgeWalk", true);
         setIntParam("optSampleRate", kDefaultSampleRate);
         setIntParam("optTimingMode", kDefaultTimingMode);
+        setIntParam("optMidiVelocity", kDefaultMidiVelocity);
+        setFloatParam("optMidiGateMs", kDefaultMidiGateMs);
+        setBoolParam("optClickQuantise", false);
+        setBoolParam("optParallelRender", false);
+        setBoolParam("optFreezePatterns", false);
+        setBoolParam("optRenderAhead", false);
+        setIntParam("optSampleStorage", 0);
+        setIntParam("optSampleMemoryMB", kDefaultSampleMemoryMB);
         setFloatParam("optSlotScale", kDefaultSlotScale);
         setIntParam("optGlowColor", kDefaultGlowRGB);
         setFloatParam("optGlowAlpha", kDefaultGlowAlpha);
@@ -1972,11 +2400,10 @@ SlotMachineAudioProcessorEditor::SlotMachineAudioProcessorEditor(SlotMachineAudi
     const int initialTimingMode = Opt::getInt(apvts, "optTimingMode", 0);
     lastTimingMode = initialTimingMode;
 
-    constexpr int slotColumns = 4;
-    const int slotRows = juce::jmax(1, (kNumSlots + slotColumns - 1) / slotColumns);
+    const int slotRows = juce::jmax(1, (kNumSlots + kSlotColumns - 1) / kSlotColumns);
     const int slotRowHeight = scaleDimension(220);
     const int chromeHeight = scaleDimension(160) + kMasterControlsYOffset; // top/bottom padding + master row + tabs space
-    setSize(1280, chromeHeight + slotRows * slotRowHeight);
+    setSize(320 * kSlotColumns, chromeHeight + slotRows * slotRowHeight);
 
     if (processor.consumeInitialiseOnFirstEditor())
         processor.initialiseStateForFirstEditor();
@@ -2056,6 +2483,9 @@ SlotMachineAudioProcessorEditor::SlotMachineAudioProcessorEditor(SlotMachineAudi
     patternWarningLabel.setVisible(false);
     patternWarningLabel.setFont(createBoldFont(13.0f));
 
+    addAndMakeVisible(cpuMeter);
+    cpuMeter.onMenuRequested = [this] { showCpuMeterMenu(); };
+
     // Slots
     const juce::Image muteOffImage = juce::ImageCache::getFromMemory(BinaryData::MuteOFF_png, BinaryData::MuteOFF_pngSize);
     const juce::Image muteOnImage  = juce::ImageCache::getFromMemory(BinaryData::MuteON_png,  BinaryData::MuteON_pngSize);
@@ -2200,6 +2630,8 @@ SlotMachineAudioProcessorEditor::SlotMachineAudioProcessorEditor(SlotMachineAudi
         auto existing = processor.getSlotFilePath(i);
         if (existing.isNotEmpty())
             ui->fileLabel.setText(juce::File(existing).getFileName(), juce::dontSendNotification);
+        if (ui->hasFile)
+            ui->fileLabel.setTooltip(describeSampleAnalysis(processor.getSlotSampleAnalysis(i)));
 
         slots[(size_t)i] = std::move(ui);
 
@@ -2224,7 +2656,7 @@ SlotMachineAudioProcessorEditor::SlotMachineAudioProcessorEditor(SlotMachineAudi
     refreshSamplesPerBar();
 
     startTimerHz(60);
-    lastPhase = (float)processor.getMasterPhase();
+    lastPhase = (float)processor.getTelemetry().cyclePhase;
 
     lastStartToggleState = startToggle.getToggleState();
     cachedStartGlowColour = Opt::rgbParam(apvts, "optGlowColor", 0x6994FC, 1.0f);
@@ -2715,6 +3147,7 @@ void SlotMachineAudioProcessorEditor::resized()
 
     auto tabsRow = area.removeFromTop(36);
     tabsRow.translate(0, -tabsLift);
+    cpuMeter.setBounds(tabsRow.removeFromRight(150).reduced(0, 4));
     auto warningArea = tabsRow.removeFromRight(220).reduced(10, 4);
     patternWarningLabel.setBounds(warningArea);
     patternTabs.setBounds(tabsRow.reduced(0, 4));
@@ -2722,8 +3155,8 @@ void SlotMachineAudioProcessorEditor::resized()
     area.translate(0, -tabsLift);
     area.setBottom(bounds.getBottom() - margin);
 
-    // Grid layout (4 columns by as many rows as needed)
-    const int columns = 4;
+    // Grid layout (kSlotColumns columns by as many rows as needed)
+    const int columns = kSlotColumns;
     const int rows = juce::jmax(1, (kNumSlots + columns - 1) / columns);
     const int gridX = area.getX(), gridY = area.getY();
     const int gridW = area.getWidth(), gridH = area.getHeight();
@@ -2872,8 +3305,7 @@ int SlotMachineAudioProcessorEditor::scaleDimensionWithMax(int base, float maxSc
 
 void SlotMachineAudioProcessorEditor::refreshSizeForSlotScale()
 {
-    constexpr int slotColumns = 4;
-    const int slotRows = juce::jmax(1, (kNumSlots + slotColumns - 1) / slotColumns);
+    const int slotRows = juce::jmax(1, (kNumSlots + kSlotColumns - 1) / kSlotColumns);
     const int slotRowHeight = scaleDimension(220);
     const int chromeHeight = 200 + kMasterControlsYOffset;
     const int newHeight = chromeHeight + slotRows * slotRowHeight;
@@ -3157,9 +3589,73 @@ void SlotMachineAudioProcessorEditor::refreshSlotFileLabels(const juce::Array<in
 
         ui->hasFile = hasSample;
         ui->fileLabel.setText(label, juce::dontSendNotification);
+        ui->fileLabel.setTooltip(hasSample ? describeSampleAnalysis(processor.getSlotSampleAnalysis(i)) : juce::String());
     }
 }
 
+void SlotMachineAudioProcessorEditor::showCpuMeterMenu()
+{
+    if (fileDialogActive)
+        return;
+
+    auto& trace = processor.getTrace();
+
+    juce::PopupMenu menu;
+    menu.addItem(1, "Record Engine Trace", true, trace.isEnabled());
+    menu.addItem(2, "Save Engine Trace...");
+
+    menu.showMenuAsync(juce::PopupMenu::Options().withTargetComponent(&cpuMeter),
+        [this](int result)
+        {
+            auto& engineTrace = processor.getTrace();
+
+            switch (result)
+            {
+            case 1: engineTrace.setEnabled(!engineTrace.isEnabled()); break;
+            case 2: saveEngineTrace(); break;
+            default: break;
+            }
+        });
+}
+
+// The trace holds the last few seconds of engine events; it is written out on a background
+// thread as Chrome trace JSON for chrome://tracing or ui.perfetto.dev
+void SlotMachineAudioProcessorEditor::saveEngineTrace()
+{
+    auto chooser = std::make_shared<juce::FileChooser>("Save engine trace", juce::File(), "*.json");
+    fileDialogActive = true;
+    chooser->launchAsync(juce::FileBrowserComponent::saveMode | juce::FileBrowserComponent::canSelectFiles,
+        [this, chooser](const juce::FileChooser& fc) mutable
+        {
+            juce::ignoreUnused(chooser);
+            fileDialogActive = false;
+            auto f = fc.getResult();
+            if (f.getFullPathName().isEmpty())
+                return;
+
+            if (!f.hasFileExtension(".json"))
+                f = f.withFileExtension(".json");
+
+            juce::Component::SafePointer<SlotMachineAudioProcessorEditor> safeThis(this);
+            const bool started = processor.getTrace().exportChromeTrace(f, [safeThis, f](bool written)
+                {
+                    if (written)
+                        return;
+
+                    juce::MessageManager::callAsync([safeThis, f]
+                        {
+                            if (safeThis != nullptr)
+                                juce::AlertWindow::showMessageBoxAsync(juce::AlertWindow::WarningIcon,
+                                    "Save Engine Trace", "Could not write " + f.getFullPathName());
+                        });
+                });
+
+            if (!started)
+                juce::AlertWindow::showMessageBoxAsync(juce::AlertWindow::InfoIcon,
+                    "Save Engine Trace", "The previous trace is still being written.");
+        });
+}
+
 void SlotMachineAudioProcessorEditor::handlePatternContextMenu(const juce::MouseEvent& e)
 {
     if (fileDialogActive)
@@ -3696,6 +4192,7 @@ void SlotMachineAudioProcessorEditor::buttonClicked(juce::Button* b)
             embeddedSlotResourceNames[(size_t)i].clear();
             ui->hasFile = false;
             ui->fileLabel.setText("No file", juce::dontSendNotification);
+            ui->fileLabel.setTooltip({});
             ui->glow = 0.0f;
             ui->phase = 0.0f;
             ui->lastHitCounter = 0;
@@ -3779,8 +4276,12 @@ void SlotMachineAudioProcessorEditor::showOptionsDialog()
     auto content = std::make_unique<OptionsComponent>(apvts, [this](float newScale)
         {
             applySlotScale(newScale);
+        },
+        [this]()
+        {
+            return describeSampleMemory(processor.getSampleMemoryUsage());
         });
-    content->setSize(640, 668);
+    content->setSize(640, 956);
 
     juce::DialogWindow::LaunchOptions opt;
     opt.dialogTitle = "Options";
@@ -3792,7 +4293,7 @@ void SlotMachineAudioProcessorEditor::showOptionsDialog()
     opt.dialogBackgroundColour = juce::Colours::black;
 
     if (auto* dlg = opt.launchAsync())
-        dlg->setResizeLimits(480, 668, 2000, 1368);
+        dlg->setResizeLimits(480, 956, 2000, 1500);
 }
 
 void SlotMachineAudioProcessorEditor::promptForExportCycles(const juce::String& dialogTitle,
@@ -4474,6 +4975,7 @@ void SlotMachineAudioProcessorEditor::doResetAll(bool persistOptions)
         {
             slots[(size_t)i]->hasFile = false;
             slots[(size_t)i]->fileLabel.setText("No file", juce::dontSendNotification);
+            slots[(size_t)i]->fileLabel.setTooltip({});
             slots[(size_t)i]->glow = 0.0f;
             slots[(size_t)i]->phase = 0.0f;
             slots[(size_t)i]->lastHitCounter = 0;
@@ -4496,10 +4998,11 @@ void SlotMachineAudioProcessorEditor::resetLoopTransport()
 {
     processor.resetAllPhases(true);
 
+    const auto telemetry = processor.getTelemetry();
     for (int i = 0; i < kNumSlots; ++i)
     {
         if (slots[(size_t)i])
-            slots[(size_t)i]->lastHitCounter = processor.getSlotHitCounter(i);
+            slots[(size_t)i]->lastHitCounter = telemetry.hitCounters[(size_t)i];
     }
 
     resetProgressVisuals();
@@ -4742,8 +5245,11 @@ void SlotMachineAudioProcessorEditor::timerCallback()
     if (isRunning)
         animateStartButton(glowColour, pulseColour);
 
+    // One consistent copy of the engine's last block for everything polled below
+    const auto telemetry = processor.getTelemetry();
+
     // 0..1 over full polyrhythmic cycle
-    const float p = juce::jlimit(0.0f, 1.0f, (float)processor.getMasterPhase());
+    const float p = juce::jlimit(0.0f, 1.0f, (float)telemetry.cyclePhase);
 
     // Detect wrap (phase jumped backwards a bit)
     const bool wrapped = (p + 0.02f) < lastPhase; // small hysteresis
@@ -4795,9 +5301,9 @@ void SlotMachineAudioProcessorEditor::timerCallback()
         auto* ui = slots[(size_t)i].get();
         if (!ui) continue;
 
-        ui->phase = (float)processor.getSlotPhase(i);
+        ui->phase = (float)telemetry.slotPhases[(size_t)i];
 
-        const uint32_t hits = processor.getSlotHitCounter(i);
+        const uint32_t hits = telemetry.hitCounters[(size_t)i];
         if (hits != ui->lastHitCounter)
         {
             ui->lastHitCounter = hits;
@@ -4822,6 +5328,7 @@ void SlotMachineAudioProcessorEditor::timerCallback()
     }
 
     consumeScopeBlocks();
+    cpuMeter.update(processor.getCpuLoad());
 
     repaint();
 }
@@ -125,6 +125,27 @@ private:
         bool suppressNextClick = false;
     };
 
+    // Audio-thread load: the last window's mean as a bar and the worst block of each window
+    // over the last few seconds as a history, with its maximum held as a marker
+    class CpuMeter : public juce::Component,
+                     public juce::SettableTooltipClient
+    {
+    public:
+        void update(const SlotMachineAudioProcessor::CpuLoad& load);
+        void paint(juce::Graphics& g) override;
+        void mouseUp(const juce::MouseEvent& e) override;
+
+        std::function<void()> onMenuRequested;
+
+    private:
+        static constexpr int kHistoryLength = 100; // windows of ~100 ms
+
+        std::array<float, kHistoryLength> peakHistory{};
+        int historyWritePos = 0;
+        uint32_t lastWindowIndex = 0;
+        float meanLoad = 0.0f;
+    };
+
     class RenamePatternComponent : public juce::Component,
                                    private juce::Button::Listener,
                                    private juce::TextEditor::Listener
@@ -286,12 +307,14 @@ private:
     };
 
     static constexpr int kNumSlots = SlotMachineAudioProcessor::kNumSlots;
+    static constexpr int kSlotColumns = kNumSlots > 16 ? 8 : 4;
     static constexpr int kMaxBeatsPerSlot = 64;
     std::array<std::unique_ptr<SlotUI>, kNumSlots> slots;
     std::array<juce::String, kNumSlots> embeddedSlotResourceNames{};
 
     PatternTabs patternTabs;
     juce::Label patternWarningLabel;
+    CpuMeter cpuMeter;
 
     // ===== Helpers =====
     void buttonClicked(juce::Button*) override;
@@ -349,6 +372,8 @@ private:
     void applyPattern(int index, bool updateTabs = true, bool saveExisting = true, bool deferIfRunning = false);
     void applyPatternTreeNow(const juce::ValueTree& pattern, bool allowTailRelease = false);
     void showPatternWarning(const juce::Array<int>& failedSlots);
+    void showCpuMeterMenu();
+    void saveEngineTrace();
     void refreshSlotFileLabels(const juce::Array<int>& failedSlots);
     juce::String defaultPatternNameForIndex(int index) const;
     void handlePatternContextMenu(const juce::MouseEvent& e);
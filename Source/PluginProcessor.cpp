@@ -1,11 +1,15 @@
 #include "PluginProcessor.h"
 #include "PluginEditor.h"
+#include "MixKernels.h"
+#include "RealtimeSafetyCheck.h"
+#include "RealtimeWake.h"
 
 #include <juce_audio_formats/juce_audio_formats.h>
 #include <vector>
 #include <array>
 #include <cmath>
 #include <algorithm>
+#include <cstring>
 #include <limits>
 
 #if __has_include("BinaryData.h")
@@ -41,6 +45,34 @@ static std::unique_ptr<juce::AudioFormatReader> makeReaderFromMemory(juce::Audio
 #endif
 }
 
+// Content fingerprint for samples decoded from memory (FNV-1a)
+static juce::String hashBytes(const void* data, int sizeBytes)
+{
+    uint64_t hash = 14695981039346656037ull;
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    for (int i = 0; i < sizeBytes; ++i)
+    {
+        hash ^= bytes[i];
+        hash *= 1099511628211ull;
+    }
+
+    return juce::String::toHexString((juce::int64)hash) + ":" + juce::String(sizeBytes);
+}
+
+// Cache identity of an audio file held in memory; the same bytes under the same name share a sample
+static juce::String memorySourceId(const juce::String& name, const void* data, int sizeBytes)
+{
+    return "memory:" + name + "@" + hashBytes(data, sizeBytes);
+}
+
+static AuditionEngine::Source embeddedAuditionSource(const juce::String& resourceName)
+{
+    AuditionEngine::Source source;
+    source.name = resourceName;
+    source.data = BinaryData::getNamedResource(resourceName.toRawUTF8(), source.sizeBytes);
+    return source;
+}
+
 static int igcd(int a, int b) { while (b) { int t = a % b; a = b; b = t; } return a < 0 ? -a : a; }
 static int ilcm(int a, int b) { return (a == 0 || b == 0) ? 0 : (a / igcd(a, b)) * b; }
 
@@ -73,9 +105,12 @@ static void accumulateCycleLength(int spacingNumerator, int spacingDenominator,
     }
 }
 
+// Decodes (up to 8 minutes of) reader into a stereo buffer at targetSampleRate, then
+// trims it to its audible content. The analysis is stored to *analysisOut if given.
 static bool decodeReaderToStereoBuffer(juce::AudioFormatReader& reader,
     double targetSampleRate,
-    juce::AudioBuffer<float>& output)
+    juce::AudioBuffer<float>& output,
+    SampleAnalysis* analysisOut = nullptr)
 {
     const int numChannels = juce::jlimit<int>(1, 2, (int)reader.numChannels);
     const double sourceRate = reader.sampleRate;
@@ -120,9 +155,15 @@ static bool decodeReaderToStereoBuffer(juce::AudioFormatReader& reader,
     }
     else
     {
-        output.makeCopyOf(buffer);
+        output = std::move(buffer);
     }
 
+    const auto analysis = SampleAnalysis::analyse(output, effectiveTarget);
+    SampleAnalysis::trimToContent(output, analysis);
+
+    if (analysisOut != nullptr)
+        *analysisOut = analysis;
+
     return output.getNumSamples() > 0;
 }
 
@@ -134,6 +175,22 @@ static constexpr float kDecayUiSkew = 0.4f;
 static constexpr float kDecayMsMin = 10.0f;
 static constexpr float kDecayMsMax = 4000.0f;
 
+static constexpr float kVoiceSilenceLevel = 1.0e-4f; // -80 dB: a decaying voice ends here
+
+// Where a voice at index with envelope level, decaying by alpha per sample, falls below
+// kVoiceSilenceLevel; never past length. A non-decaying envelope plays to the end.
+static int findSilentEnd(int index, int length, float level, float alpha)
+{
+    if (alpha >= 1.0f || alpha <= 0.0f)
+        return length;
+
+    if (level <= kVoiceSilenceLevel)
+        return juce::jmin(index, length);
+
+    const double samplesToSilence = std::ceil(std::log((double)kVoiceSilenceLevel / (double)level) / std::log((double)alpha));
+    return (int)juce::jmin((double)length, (double)index + samplesToSilence);
+}
+
 static const juce::Identifier kStateVersionProperty("slotMachineStateVersion");
 static const juce::Identifier kAutoInitialiseProperty("slotMachineAutoInitialise");
 static const juce::Identifier kPatternsNodeId("patterns");
@@ -202,7 +259,7 @@ static void approximateRational(double x, int maxDen, int& num, int& den)
     num = n1; den = d1;
 }
 
-static const juce::StringArray kSlotParamSuffixes{ "Mute", "Solo", "Rate", "Count", "Gain", "Pan", "Decay", "MidiChannel" };
+static const juce::StringArray kSlotParamSuffixes{ "Mute", "Solo", "Rate", "Count", "Gain", "Pan", "Decay", "MidiChannel", "TriggerNote" };
 
 static juce::String slotParamId(int slotIndex, const juce::String& suffix)
 {
@@ -262,6 +319,42 @@ static juce::String serialiseCountMaskValue(uint64_t mask)
     auto text = juce::String::toHexString((juce::uint64)mask).toUpperCase();
     return text.paddedLeft('0', 16);
 }
+
+// Fetches a sample through the shared cache, decoding only on a miss. Either thread that may
+// block: the message thread for the slots, the export for its own voices.
+static bool acquireFileSample(SampleMemoryManager& memory, const juce::File& f, double rate,
+    StoredSample::Format format, StoredSample& sample, SampleAnalysis& analysis)
+{
+    auto decode = [&f, rate](juce::AudioBuffer<float>& decoded, SampleAnalysis& decodedAnalysis)
+    {
+        juce::AudioFormatManager fm;
+        fm.registerBasicFormats();
+        std::unique_ptr<juce::AudioFormatReader> r(fm.createReaderFor(f));
+        return r != nullptr && decodeReaderToStereoBuffer(*r, rate, decoded, &decodedAnalysis);
+    };
+
+    const auto modified = f.getLastModificationTime().toMilliseconds();
+    return memory.acquire(f.getFullPathName(), modified, rate, format, decode, sample, analysis)
+        && sample.getNumSamples() > 0;
+}
+
+static bool acquireMemorySample(SampleMemoryManager& memory, const void* data, int sizeBytes, const juce::String& pseudoName,
+    double rate, StoredSample::Format format, StoredSample& sample, SampleAnalysis& analysis)
+{
+    if (data == nullptr || sizeBytes <= 0)
+        return false;
+
+    auto decode = [data, sizeBytes, rate](juce::AudioBuffer<float>& decoded, SampleAnalysis& decodedAnalysis)
+    {
+        juce::AudioFormatManager fm;
+        fm.registerBasicFormats();
+        auto reader = makeReaderFromMemory(fm, data, sizeBytes);
+        return reader != nullptr && decodeReaderToStereoBuffer(*reader, rate, decoded, &decodedAnalysis);
+    };
+
+    return memory.acquire(memorySourceId(pseudoName, data, sizeBytes), 0, rate, format, decode, sample, analysis)
+        && sample.getNumSamples() > 0;
+}
 }
 
 // 
@@ -272,13 +365,16 @@ void SlotMachineAudioProcessor::SlotVoice::prepare(double sr)
     resetPhase(true);
     playIndex = -1;
     playLength = 0;
+    hitGain = 1.0f;
     env = 0.0f; envAlpha = 1.0f; envSamplesElapsed = 0; envMaxSamples = 0;
-    tailSample.setSize(0, 0);
+    tailSample.reset();
+    tailReleasePending = false;
     tailIndex = -1;
     tailLength = 0;
     tailEnv = 0.0f; tailEnvAlpha = 1.0f; tailEnvSamplesElapsed = 0; tailEnvMaxSamples = 0;
     tailPanL = panL;
     tailPanR = panR;
+    tailHitGain = 1.0f;
     tailActive = false;
 }
 
@@ -288,6 +384,8 @@ void SlotMachineAudioProcessor::SlotVoice::resetPhase(bool hard)
     {
         phase = 0.0;
         framesUntilHit = 0.0;
+        pendingClickBeat = -1.0;
+        hitsDueNextBlock = 0;
     }
 }
 
@@ -299,77 +397,49 @@ void SlotMachineAudioProcessor::SlotVoice::setPan(float pan)
     panR = std::sin(theta);
 }
 
-void SlotMachineAudioProcessor::SlotVoice::loadFile(const juce::File& f)
+void SlotMachineAudioProcessor::SlotVoice::loadFile(const juce::File& f, SampleMemoryManager& memory, StoredSample::Format format)
 {
-    juce::AudioFormatManager fm;
-    fm.registerBasicFormats();
-    std::unique_ptr<juce::AudioFormatReader> r(fm.createReaderFor(f));
-
-    active = false;
-    sample.setSize(0, 0);
-    filePath = {};
-
-    if (r != nullptr)
-    {
-        juce::AudioBuffer<float> decoded;
-        if (decodeReaderToStereoBuffer(*r, sampleRate, decoded))
-        {
-            sample = std::move(decoded);
-            active = (sample.getNumSamples() > 0);
-            filePath = f.getFullPathName();
-
-            playIndex = -1;
-            playLength = 0;
-            env = 0.0f; envSamplesElapsed = 0; envMaxSamples = 0;
-        }
-    }
+    SampleAnalysis ignored;
+    sample.reset();
+    acquireFileSample(memory, f, sampleRate, format, sample, ignored);
+    active = (sample.getNumSamples() > 0);
 
+    playIndex = -1;
+    playLength = 0;
+    env = 0.0f; envSamplesElapsed = 0;
 }
 
-void SlotMachineAudioProcessor::SlotVoice::loadFromMemory(const void* data, int sizeBytes, const juce::String& pseudoName)
+void SlotMachineAudioProcessor::SlotVoice::loadFromMemory(const void* data, int sizeBytes, const juce::String& pseudoName,
+    SampleMemoryManager& memory, StoredSample::Format format)
 {
-    active = false;
-    sample.setSize(0, 0);
-    filePath = pseudoName;
-
-    if (data == nullptr || sizeBytes <= 0)
-        return;
-
-    juce::AudioFormatManager fm;
-    fm.registerBasicFormats();
-
-    auto reader = makeReaderFromMemory(fm, data, sizeBytes);
-    if (reader == nullptr)
-        return;
-
-    juce::AudioBuffer<float> decoded;
-    if (decodeReaderToStereoBuffer(*reader, sampleRate, decoded))
-    {
-        sample = std::move(decoded);
-        active = (sample.getNumSamples() > 0);
+    SampleAnalysis ignored;
+    sample.reset();
+    acquireMemorySample(memory, data, sizeBytes, pseudoName, sampleRate, format, sample, ignored);
+    active = (sample.getNumSamples() > 0);
 
-        playIndex = -1;
-        playLength = 0;
-        env = 0.0f;
-        envSamplesElapsed = 0;
-        envMaxSamples = 0;
-    }
+    playIndex = -1;
+    playLength = 0;
+    env = 0.0f;
+    envSamplesElapsed = 0;
 }
 
-void SlotMachineAudioProcessor::SlotVoice::trigger()
+void SlotMachineAudioProcessor::SlotVoice::trigger(float velocityGain)
 {
     if (!hasSample())
         return;
 
     playIndex = 0;
-    playLength = sample.getNumSamples();
     ++hitCounter;
+    hitGain = juce::jlimit(0.0f, 1.0f, velocityGain);
     env = 1.0f; envSamplesElapsed = 0;
+
+    // Stop where the decay becomes inaudible rather than running on to the end of the sample
+    playLength = findSilentEnd(0, sample.getNumSamples(), env, envAlpha);
 }
 
 void SlotMachineAudioProcessor::SlotVoice::mixInto(juce::AudioBuffer<float>& io, int numSamples, float gain)
 {
-    auto mixBuffer = [&io](const juce::AudioBuffer<float>& src, int& index, int length,
+    auto mixBuffer = [&io](const StoredSample& src, int& index, int length,
         float& envLevel, float& envAlphaRef, int& envSamples, int envSamplesMax,
         float panLeft, float panRight, int numSamplesToProcess, float gainScale)
     {
@@ -385,46 +455,16 @@ void SlotMachineAudioProcessor::SlotVoice::mixInto(juce::AudioBuffer<float>& io,
         const float gL = gainScale * panLeft;
         const float gR = gainScale * panRight;
 
-        const float* srcL = src.getNumSamples() > 0 ? src.getReadPointer(0, index) : nullptr;
-        const float* srcR = (src.getNumChannels() > 1 && src.getNumSamples() > 0)
-            ? src.getReadPointer(1, index)
-            : nullptr;
-
-        if (srcL == nullptr)
+        if (src.getChannel(0) == nullptr)
             return 0;
 
-        if (dstR != nullptr && srcR != nullptr)
-        {
-            for (int i = 0; i < n; ++i)
-            {
-                const float envValue = envLevel;
-                dstL[i] += srcL[i] * gL * envValue;
-                dstR[i] += srcR[i] * gR * envValue;
-                envLevel *= envAlphaRef;
-                ++envSamples;
-            }
-        }
-        else if (dstR != nullptr)
-        {
-            for (int i = 0; i < n; ++i)
-            {
-                const float s = srcL[i];
-                const float envValue = envLevel;
-                dstL[i] += s * gL * envValue;
-                dstR[i] += s * gR * envValue;
-                envLevel *= envAlphaRef;
-                ++envSamples;
-            }
-        }
-        else
-        {
-            for (int i = 0; i < n; ++i)
-            {
-                dstL[i] += srcL[i] * gainScale * envLevel;
-                envLevel *= envAlphaRef;
-                ++envSamples;
-            }
-        }
+        // A mono destination takes the left channel without pan
+        MixKernels::EnvelopeState envState { envLevel, envAlphaRef };
+        MixKernels::mixSource(src.getFormat(), src.getChannel(0), src.getChannel(1), index,
+            dstL, dstR, n,
+            (dstR != nullptr ? gL : gainScale) * src.getScale(), gR * src.getScale(), envState);
+        envLevel = envState.level;
+        envSamples += n;
 
         index += n;
         if (envSamplesMax > 0 && envSamples >= envSamplesMax && envLevel < 1.0e-4f)
@@ -439,21 +479,14 @@ void SlotMachineAudioProcessor::SlotVoice::mixInto(juce::AudioBuffer<float>& io,
     {
         const int mixed = mixBuffer(tailSample, tailIndex, tailLength,
             tailEnv, tailEnvAlpha, tailEnvSamplesElapsed, tailEnvMaxSamples,
-            tailPanL, tailPanR, numSamples, gain);
+            tailPanL, tailPanR, numSamples, gain * tailHitGain);
         if (tailIndex < 0 || mixed <= 0)
-        {
-            tailSample.setSize(0, 0);
-            tailIndex = -1;
-            tailLength = 0;
-            tailEnv = 0.0f; tailEnvAlpha = 1.0f; tailEnvSamplesElapsed = 0; tailEnvMaxSamples = 0;
-            tailPanL = panL; tailPanR = panR;
-            tailActive = false;
-        }
+            releaseTail();
     }
 
     mixBuffer(sample, playIndex, playLength,
         env, envAlpha, envSamplesElapsed, envMaxSamples,
-        panL, panR, numSamples, gain);
+        panL, panR, numSamples, gain * hitGain);
 }
 
 void SlotMachineAudioProcessor::SlotVoice::stopImmediate() noexcept
@@ -463,23 +496,76 @@ void SlotMachineAudioProcessor::SlotVoice::stopImmediate() noexcept
     env = 0.0f;
     envSamplesElapsed = 0;
 
-    tailSample.setSize(0, 0);
+    releaseTail();
+}
+
+// Audio thread: the tail may hold the last handle to its sample, so the release thread drops it
+void SlotMachineAudioProcessor::SlotVoice::releaseTail() noexcept
+{
+    retireTailSample();
+
     tailIndex = -1;
     tailLength = 0;
-    tailEnv = 0.0f;
-    tailEnvAlpha = 1.0f;
-    tailEnvSamplesElapsed = 0;
-    tailEnvMaxSamples = 0;
-    tailPanL = panL;
-    tailPanR = panR;
+    tailEnv = 0.0f; tailEnvAlpha = 1.0f; tailEnvSamplesElapsed = 0; tailEnvMaxSamples = 0;
+    tailPanL = panL; tailPanR = panR;
+    tailHitGain = 1.0f;
     tailActive = false;
 }
 
-void SlotMachineAudioProcessor::SlotVoice::clear(bool allowTail) noexcept
+// Audio thread: hands s to the release queue, leaving it empty. Offline (no queue) the caller is
+// not the audio thread and releases in place. False, with s untouched, when the queue is full.
+bool SlotMachineAudioProcessor::SlotVoice::retireSample(StoredSample& s) noexcept
+{
+    const bool hadSample = s.getNumSamples() > 0;
+
+    if (releaseQueue == nullptr)
+    {
+        s.reset();
+        return true;
+    }
+
+    if (s.getNumHandles() > 0 && !releaseQueue->retire(s))
+        return false;
+
+    if (hadSample && trace != nullptr)
+        trace->record(AudioTrace::Type::sampleRetired, index);
+    return true;
+}
+
+// Audio thread: when the queue is full the handle stays in tailSample, never dropped here, and
+// the engine retries at the start of the next block
+void SlotMachineAudioProcessor::SlotVoice::retireTailSample() noexcept
+{
+    tailReleasePending = !retireSample(tailSample);
+}
+
+// Audio thread, between blocks: incoming (possibly empty) replaces the slot's sample. With
+// allowTail a hit still playing rings on as the tail. Every handle the slot lets go of goes to
+// the release queue; any the full queue refused end up in unreleased for the caller to drop.
+void SlotMachineAudioProcessor::SlotVoice::replaceSample(StoredSample& incoming, bool allowTail,
+    std::array<StoredSample, 2>& unreleased) noexcept
 {
+    auto retireOrHandBack = [this, &unreleased](StoredSample& s, size_t cell)
+    {
+        if (!retireSample(s))
+            unreleased[cell] = std::move(s);
+    };
+
+    auto resetTail = [this]
+    {
+        tailIndex = -1;
+        tailLength = 0;
+        tailEnv = 0.0f; tailEnvAlpha = 1.0f; tailEnvSamplesElapsed = 0; tailEnvMaxSamples = 0;
+        tailPanL = panL; tailPanR = panR;
+        tailHitGain = 1.0f;
+        tailActive = false;
+    };
+
     if (allowTail && playIndex >= 0 && playLength > playIndex && sample.getNumSamples() > 0)
     {
+        retireOrHandBack(tailSample, 0);
         tailSample = std::move(sample);
+        tailReleasePending = false;
         tailIndex = playIndex;
         tailLength = playLength;
         tailEnv = env;
@@ -488,36 +574,28 @@ void SlotMachineAudioProcessor::SlotVoice::clear(bool allowTail) noexcept
         tailEnvMaxSamples = envMaxSamples;
         tailPanL = panL;
         tailPanR = panR;
+        tailHitGain = hitGain;
         tailActive = true;
     }
-    else if (!allowTail)
+    else if (!allowTail || !tailActive)
     {
-        tailSample.setSize(0, 0);
-        tailIndex = -1;
-        tailLength = 0;
-        tailEnv = 0.0f; tailEnvAlpha = 1.0f; tailEnvSamplesElapsed = 0; tailEnvMaxSamples = 0;
-        tailPanL = panL; tailPanR = panR;
-        tailActive = false;
-    }
-    else if (!tailActive)
-    {
-        // allowTail was requested but nothing is currently ringing, ensure clean state
-        tailSample.setSize(0, 0);
-        tailIndex = -1;
-        tailLength = 0;
-        tailEnv = 0.0f; tailEnvAlpha = 1.0f; tailEnvSamplesElapsed = 0; tailEnvMaxSamples = 0;
-        tailPanL = panL; tailPanR = panR;
-        tailActive = false;
+        // Nothing to ring on (allowTail with nothing playing included): start from a clean tail
+        retireOrHandBack(tailSample, 0);
+        tailReleasePending = false;
+        resetTail();
     }
 
-    sample.setSize(0, 0);
-    active = false;
-    filePath = {};
+    retireOrHandBack(sample, 1);
+    sample = std::move(incoming);
+    active = (sample.getNumSamples() > 0);
     playIndex = -1;
     playLength = 0;
     phase = 0.0;
     framesUntilHit = 0.0;
-    env = 0.0f; envAlpha = 1.0f; envSamplesElapsed = 0; envMaxSamples = 0;
+    pendingClickBeat = -1.0;
+    hitsDueNextBlock = 0;
+    hitGain = 1.0f;
+    env = 0.0f; envSamplesElapsed = 0;
     if (!tailActive)
         tailEnv = 0.0f;
 }
@@ -540,10 +618,127 @@ SlotMachineAudioProcessor::SlotMachineAudioProcessor()
         apvts.state.setProperty(kAutoInitialiseProperty, true, nullptr);
     initialiseOnFirstEditor = static_cast<bool>(apvts.state.getProperty(kAutoInitialiseProperty, true));
 
+    sampleMemory->setDiskCacheDirectory(juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
+        .getChildFile(JucePlugin_Manufacturer)
+        .getChildFile(JucePlugin_Name)
+        .getChildFile("SampleCache"));
+
+    for (int i = 0; i < kNumSlots; ++i)
+    {
+        slots[(size_t)i].releaseQueue = &sampleReleases;
+        slots[(size_t)i].trace = &trace;
+        slots[(size_t)i].index = i;
+    }
+
     refreshSlotCountMasksFromState();
+    cacheParameterHandles();
+}
+
+SlotMachineAudioProcessor::~SlotMachineAudioProcessor()
+{
+    stopRenderAhead();
+
+    for (int i = 0; i < kNumSlots; ++i)
+    {
+        apvts.removeParameterListener(slotParamId(i, "Pan"), this);
+        apvts.removeParameterListener(slotParamId(i, "Decay"), this);
+        apvts.removeParameterListener(slotParamId(i, "Rate"), this);
+    }
+
+    apvts.removeParameterListener("optTimingMode", this);
+    apvts.removeParameterListener("optSampleMemoryMB", this);
 }
 
-SlotMachineAudioProcessor::~SlotMachineAudioProcessor() {}
+void SlotMachineAudioProcessor::cacheParameterHandles()
+{
+    for (int i = 0; i < kNumSlots; ++i)
+    {
+        auto& p = slotParams[(size_t)i];
+        p.mute = apvts.getRawParameterValue(slotParamId(i, "Mute"));
+        p.solo = apvts.getRawParameterValue(slotParamId(i, "Solo"));
+        p.rate = apvts.getRawParameterValue(slotParamId(i, "Rate"));
+        p.count = apvts.getRawParameterValue(slotParamId(i, "Count"));
+        p.gain = apvts.getRawParameterValue(slotParamId(i, "Gain"));
+        p.pan = apvts.getRawParameterValue(slotParamId(i, "Pan"));
+        p.decay = apvts.getRawParameterValue(slotParamId(i, "Decay"));
+        p.midiChannel = apvts.getRawParameterValue(slotParamId(i, "MidiChannel"));
+        p.triggerNote = apvts.getRawParameterValue(slotParamId(i, "TriggerNote"));
+
+        apvts.addParameterListener(slotParamId(i, "Pan"), this);
+        apvts.addParameterListener(slotParamId(i, "Decay"), this);
+        apvts.addParameterListener(slotParamId(i, "Rate"), this);
+    }
+
+    masterRunParam = apvts.getRawParameterValue("masterRun");
+    masterBpmParam = apvts.getRawParameterValue("masterBPM");
+    timingModeParam = apvts.getRawParameterValue("optTimingMode");
+    clickQuantiseParam = apvts.getRawParameterValue("optClickQuantise");
+    midiGateParam = apvts.getRawParameterValue("optMidiGateMs");
+    midiVelocityParam = apvts.getRawParameterValue("optMidiVelocity");
+    parallelRenderParam = apvts.getRawParameterValue("optParallelRender");
+    freezePatternsParam = apvts.getRawParameterValue("optFreezePatterns");
+    renderAheadParam = apvts.getRawParameterValue("optRenderAhead");
+    sampleStorageParam = apvts.getRawParameterValue("optSampleStorage");
+    sampleMemoryParam = apvts.getRawParameterValue("optSampleMemoryMB");
+
+    apvts.addParameterListener("optTimingMode", this);
+    apvts.addParameterListener("optSampleMemoryMB", this);
+    sampleMemory->setBudgetBytes(getSampleMemoryBudgetBytes());
+
+    markAllDerivedStateDirty();
+}
+
+void SlotMachineAudioProcessor::markAllDerivedStateDirty() noexcept
+{
+    for (auto& flags : slotDirtyFlags)
+        flags.fetch_or(kDirtyAll, std::memory_order_release);
+
+    cycleDirty.store(true, std::memory_order_release);
+    invalidateFrozenCycle();
+}
+
+// May be called on any thread, including the audio thread during host automation,
+// so it only raises flags and must not allocate.
+void SlotMachineAudioProcessor::parameterChanged(const juce::String& parameterID, float)
+{
+    if (parameterID == "optTimingMode")
+    {
+        cycleDirty.store(true, std::memory_order_release);
+        return;
+    }
+
+    if (parameterID == "optSampleMemoryMB")
+    {
+        sampleMemory->setBudgetBytes(getSampleMemoryBudgetBytes());
+
+        // Evicting frees memory, so a change from the host's audio thread waits for the next load
+        if (juce::MessageManager::existsAndIsCurrentThread())
+            sampleMemory->trim();
+        return;
+    }
+
+    // "slot<N>_<Suffix>"
+    auto text = parameterID.getCharPointer();
+    for (const char* prefix = "slot"; *prefix != 0; ++prefix, ++text)
+        if (*text != (juce::juce_wchar)*prefix)
+            return;
+
+    int slotNumber = 0;
+    while (text.isDigit())
+        slotNumber = slotNumber * 10 + (int)(text.getAndAdvance() - '0');
+
+    const int index = slotNumber - 1;
+    if (!juce::isPositiveAndBelow(index, kNumSlots))
+        return;
+
+    uint32_t flag = 0;
+    if (parameterID.endsWith("_Pan"))        flag = kDirtyPan;
+    else if (parameterID.endsWith("_Decay")) flag = kDirtyDecay;
+    else if (parameterID.endsWith("_Rate"))  flag = kDirtyRate;
+
+    if (flag != 0)
+        slotDirtyFlags[(size_t)index].fetch_or(flag, std::memory_order_release);
+}
 
 //==============================================================================
 // Parameters (master, slots, and Options)
@@ -594,6 +789,10 @@ APVTS::ParameterLayout SlotMachineAudioProcessor::createParameterLayout()
         layout.add(std::make_unique<juce::AudioParameterChoice>(
             base + "MidiChannel", "Slot " + juce::String(i) + " MIDI Channel",
             midiChannelChoices, juce::jlimit(0, midiChannelChoices.size() - 1, i - 1)));
+
+        layout.add(std::make_unique<juce::AudioParameterInt>(
+            base + "TriggerNote", "Slot " + juce::String(i) + " MIDI Trigger Note",
+            0, 127, juce::jlimit(0, 127, kDefaultTriggerNoteBase + i - 1)));
     }
 
     // ===== Options (persisted) =====
@@ -603,9 +802,23 @@ APVTS::ParameterLayout SlotMachineAudioProcessor::createParameterLayout()
         "optShowSlotBars", "Show Slot Progress Bars", true));
     layout.add(std::make_unique<juce::AudioParameterBool>(
         "optShowVisualizer", "Show Visualizer", false));
+    layout.add(std::make_unique<juce::AudioParameterBool>(
+        "optParallelRender", "Multi-core Slot Rendering", false));
+    layout.add(std::make_unique<juce::AudioParameterBool>(
+        "optFreezePatterns", "Freeze Static Patterns", false));
+    layout.add(std::make_unique<juce::AudioParameterBool>(
+        "optRenderAhead", "Render Ahead", false));
     layout.add(std::make_unique<juce::AudioParameterBool>(
         "optVisualizerEdgeWalk", "Visualizer Edge Walk", true));
 
+    // How newly loaded samples are held in memory: 0 = 32-bit float, 1 = 16-bit integer, 2 = 16-bit float
+    layout.add(std::make_unique<juce::AudioParameterInt>(
+        "optSampleStorage", "Sample Storage", 0, 2, 0));
+
+    // Resident decoded audio kept across slots, tails and the sample cache
+    layout.add(std::make_unique<juce::AudioParameterInt>(
+        "optSampleMemoryMB", "Sample Memory Budget (MB)", 128, 16384, 1024));
+
     layout.add(std::make_unique<juce::AudioParameterInt>(
         "optSampleRate", "Export Sample Rate (Hz)", 44100, 48000, 48000));
 
@@ -634,6 +847,19 @@ APVTS::ParameterLayout SlotMachineAudioProcessor::createParameterLayout()
     layout.add(std::make_unique<juce::AudioParameterInt>(
         "optTimingMode", "Timing Mode", 0, 1, 0));
 
+    // Snap slot clicks to the slot's own grid while the transport runs
+    layout.add(std::make_unique<juce::AudioParameterBool>(
+        "optClickQuantise", "Quantise Slot Clicks", false));
+
+    // Length of the MIDI notes emitted for each hit
+    layout.add(std::make_unique<juce::AudioParameterFloat>(
+        "optMidiGateMs", "MIDI Note Length (ms)",
+        juce::NormalisableRange<float>(1.0f, 1000.0f, 1.0f, 0.4f), 10.0f));
+
+    // How strongly incoming MIDI velocity scales the hit gain (0 = ignore velocity)
+    layout.add(std::make_unique<juce::AudioParameterInt>(
+        "optMidiVelocity", "MIDI In Velocity Sensitivity (%)", 0, 100, 100));
+
     return layout;
 }
 
@@ -641,33 +867,118 @@ APVTS::ParameterLayout SlotMachineAudioProcessor::createParameterLayout()
 // Prepare / Release
 void SlotMachineAudioProcessor::prepareToPlay(double sampleRate, int samplesPerBlock)
 {
-    juce::ignoreUnused(samplesPerBlock);
+    // The engine is about to be reset under the render-ahead thread's feet
+    stopRenderAhead();
+
     currentSampleRate = sampleRate;
     masterBeatsAccum = 0.0;
 
     for (auto& s : slots)
         s.prepare(sampleRate);
 
-    {
-        const juce::SpinLock::ScopedLockType lock(previewLock);
-        previewVoice.reset();
-    }
+    audition.prepare(sampleRate);
 
     scopeQueue.reset();
-    scratchMono.setSize(1, juce::jmax(1, samplesPerBlock));
+    // The scope downmix works a scope block at a time, so this never has to grow with the host's blocks
+    scratchMono.setSize(1, kScopeBlockSize);
     scratchMono.clear();
+    midiScratch.ensureSize(4096);
+    midiScratch.clear();
+    for (auto& bank : voiceBanks)
+        bank.clear();
+
+    // One worker per spare core, leaving a core for the host and the UI
+    const int spareCores = juce::SystemStats::getNumCpus() - 2;
+    renderPool.start(juce::jlimit(0, RenderWorkerPool::kMaxWorkers, juce::jmin(spareCores, kNumRenderGroups - 1)));
+
+    for (auto& scratch : renderScratch)
+        scratch.setSize(2, juce::jmax(1, samplesPerBlock), false, true, true);
+    renderScratchUsed.fill(false);
+
+    // The loop is up to kMaxFrozenLoopSeconds of stereo audio, so it exists only while the option
+    // is on; like render-ahead, switching it takes effect at the next prepare
+    freezeAvailable = freezePatternsParam->load() >= 0.5f;
+    if (freezeAvailable)
+    {
+        frozenLoop.setSize(2, juce::jmax(1, (int)std::ceil(sampleRate * kMaxFrozenLoopSeconds)), false, true, false);
+        frozenScratch.setSize(2, juce::jmax(1, samplesPerBlock), false, true, false);
+    }
+    else
+    {
+        frozenLoop.setSize(0, 0);
+        frozenScratch.setSize(0, 0);
+    }
+    freezeState = FreezeState::live;
+    frozenPatternSignature = 0;
+    frozenBlockEndBeats = -1.0;
+
+    cpuLoadMeter.prepare(sampleRate);
+
+    manualTriggerQueue.reset();
+    lastBlockStartTicks = 0;
+    engineSampleClock = 0;
+    // Note-offs for notes already sent still go out, first thing in the next block: the clock
+    // they were scheduled on has just been reset
+    flushScheduledMidi = scheduledMidi.getNumPending() > 0;
+
+    // Decay coefficients depend on the sample rate
+    markAllDerivedStateDirty();
 
     resetAllPhases(true);
+
+    startRenderAhead(samplesPerBlock);
 }
 
-void SlotMachineAudioProcessor::releaseResources() {}
+void SlotMachineAudioProcessor::releaseResources()
+{
+    stopRenderAhead();
+    renderPool.stop();
+}
 
 //==============================================================================
 // Processing (MASTER-LOCKED PHASE/HITS)
+// UI clicks: each carries the time it was made. Clicks made during the previous callback
+// interval land at the same relative position in this block, so every click is delayed by
+// exactly one callback period instead of jittering by up to a buffer. Host callback only.
+template <typename Fn>
+void SlotMachineAudioProcessor::popManualTriggers(int numSamples, Fn&& onTrigger)
+{
+    const juce::int64 blockStartTicks = juce::Time::getHighResolutionTicks();
+    const double ticksPerSample = (double)juce::Time::getHighResolutionTicksPerSecond() / currentSampleRate;
+    const juce::int64 referenceTicks = lastBlockStartTicks;
+    const bool useTimestamps = !isNonRealtime() && referenceTicks > 0 && ticksPerSample > 0.0;
+    lastBlockStartTicks = blockStartTicks;
+
+    manualTriggerQueue.popAll([&](const ManualTriggerEvent& event)
+    {
+        int offset = 0;
+        if (useTimestamps && event.ticks > referenceTicks)
+            offset = (int)std::floor((double)(event.ticks - referenceTicks) / ticksPerSample);
+
+        onTrigger(event.slot, juce::jlimit(0, juce::jmax(0, numSamples - 1), offset));
+    });
+}
+
 void SlotMachineAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midi)
 {
     juce::ScopedNoDenormals noDenormals;
+    const RealtimeSafety::ScopedAudioCallback audioCallback; // checks for allocation and locking in SLOTMACHINE_RT_CHECK builds
+    const juce::int64 blockStartTicks = LoadMeter::now();
+    trace.record(AudioTrace::Type::blockStart, -1, buffer.getNumSamples());
+
+    if (renderAheadActive)
+        drainRenderAhead(buffer, midi);
+    else
+        renderEngineBlock(buffer, midi, false);
 
+    // Rendering ahead, the engine's stages run on their own thread; only the hand-off counts against this callback
+    cpuLoadMeter.addBlock(LoadMeter::now() - blockStartTicks, buffer.getNumSamples(),
+                          renderAheadActive ? nullptr : &engineTimes);
+    trace.record(AudioTrace::Type::blockEnd);
+}
+
+void SlotMachineAudioProcessor::renderEngineBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midi, bool renderingAhead)
+{
     const int  numSamples = buffer.getNumSamples();
     const int  totalOut = getTotalNumOutputChannels();
     const int  totalIn = getTotalNumInputChannels();
@@ -675,8 +986,17 @@ void SlotMachineAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, j
     for (int ch = totalIn; ch < totalOut; ++ch)
         buffer.clear(ch, 0, numSamples);
 
-    const bool run = apvts.getRawParameterValue("masterRun")->load();
-    const float masterBPM = *apvts.getRawParameterValue("masterBPM");
+    engineTimes.clear();
+
+    takePendingSamples();
+
+    // Tails the release queue had no room for last block
+    for (auto& s : slots)
+        if (s.tailReleasePending && !s.tailActive)
+            s.retireTailSample();
+
+    const bool run = masterRunParam->load() >= 0.5f;
+    const float masterBPM = masterBpmParam->load();
     const double spb = (masterBPM > 0.0f ? 60.0 / (double)masterBPM : 0.0); // seconds per beat
 
     // Always emit both audio and MIDI
@@ -686,70 +1006,211 @@ void SlotMachineAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, j
     bpmAtomic.store((double) masterBPM, std::memory_order_relaxed);
     numeratorAtomic.store(kCountModeBaseBeats, std::memory_order_relaxed);
 
+    // Stopped with nothing sounding and nothing arriving: the block is silence, so skip the
+    // slot loop, the renderer and (after the scope has been flushed) the scope downmix
+    if (!run && midi.isEmpty() && manualTriggerQueue.getNumReady() == 0 && numRenderAheadClicks == 0
+        && !isAnyVoiceSounding())
+    {
+        freezeState = FreezeState::live;
+        if (!renderingAhead)
+            lastBlockStartTicks = juce::Time::getHighResolutionTicks(); // keeps the next click's timestamp reference fresh
+
+        flushNoteOffsLeftByPrepare(midi);
+        scheduledMidi.renderBlock(midi, engineSampleClock, numSamples);
+        engineSampleClock += numSamples;
+
+        if (idleScopeSamplesPushed < kScopeBlockSize * kScopeBlocks)
+        {
+            scratchMono.clear();
+            for (int offset = 0; offset < numSamples; offset += kScopeBlockSize)
+                scopeQueue.push(scratchMono.getReadPointer(0), juce::jmin(kScopeBlockSize, numSamples - offset));
+            idleScopeSamplesPushed += numSamples;
+        }
+
+        publishTelemetry(buffer, numSamples);
+        return;
+    }
+
+    idleScopeSamplesPushed = 0;
+
     // Solo mask
     bool anySolo = false;
     bool soloMask[kNumSlots] = {};
     for (int i = 0; i < kNumSlots; ++i)
     {
-        const bool solo = apvts.getRawParameterValue("slot" + juce::String(i + 1) + "_Solo")->load();
+        const bool solo = slotParams[(size_t)i].solo->load() >= 0.5f;
         soloMask[i] = solo;
         anySolo = anySolo || solo;
     }
 
+    // MIDI input: note-ons matching a slot's trigger note fire that slot at the event's sample
+    // offset in this block. Matched notes are consumed; everything else passes through.
+    int numExternalTriggers = 0;
+    const float velocitySensitivity = juce::jlimit(0.0f, 1.0f,
+        midiVelocityParam->load() * 0.01f);
+
+    if (!midi.isEmpty())
+    {
+        std::array<int, kNumSlots> triggerNotes{};
+        for (int i = 0; i < kNumSlots; ++i)
+            triggerNotes[(size_t)i] = juce::jlimit(0, 127,
+                (int)std::round(slotParams[(size_t)i].triggerNote->load()));
+
+        bool consumedAny = false;
+        midiScratch.clear();
+
+        for (const auto metadata : midi)
+        {
+            const auto message = metadata.getMessage();
+            bool mapped = false;
+
+            if (message.isNoteOnOrOff())
+            {
+                for (int i = 0; i < kNumSlots; ++i)
+                {
+                    if (triggerNotes[(size_t)i] != message.getNoteNumber())
+                        continue;
+
+                    mapped = true;
+
+                    if (message.isNoteOn() && numExternalTriggers < kMaxExternalTriggersPerBlock)
+                    {
+                        auto& trigger = externalTriggers[(size_t)numExternalTriggers++];
+                        trigger.slot = i;
+                        trigger.offset = juce::jlimit(0, juce::jmax(0, numSamples - 1), metadata.samplePosition);
+                        trigger.velocity = message.getFloatVelocity();
+                        trigger.fromClick = false;
+                    }
+                }
+            }
+
+            if (mapped)
+                consumedAny = true;
+            else
+                midiScratch.addEvent(message, metadata.samplePosition);
+        }
+
+        if (consumedAny)
+        {
+            midi.clear();
+            midi.addEvents(midiScratch, 0, -1, 0);
+        }
+    }
+
+    // After input matching, which would consume them, and before this block's hits
+    flushNoteOffsLeftByPrepare(midi);
+
+    // UI clicks: rendering ahead, the callback has already placed them on the engine clock
+    auto addClickTrigger = [this, &numExternalTriggers](int slot, int offset)
+    {
+        if (!juce::isPositiveAndBelow(slot, kNumSlots) || numExternalTriggers >= kMaxExternalTriggersPerBlock)
+            return;
+
+        auto& trigger = externalTriggers[(size_t)numExternalTriggers++];
+        trigger.slot = slot;
+        trigger.offset = offset;
+        trigger.velocity = 1.0f;
+        trigger.fromClick = true;
+    };
+
+    if (renderingAhead)
+    {
+        for (int c = 0; c < numRenderAheadClicks; ++c)
+            addClickTrigger(renderAheadClicks[(size_t)c].slot, renderAheadClicks[(size_t)c].offset);
+        numRenderAheadClicks = 0;
+    }
+    else
+    {
+        popManualTriggers(numSamples, addClickTrigger);
+    }
+
+    const bool quantiseClicks = clickQuantiseParam->load() >= 0.5f;
+    const float gateMs = midiGateParam->load();
+    const juce::int64 gateSamples = juce::jmax<juce::int64>(1, (juce::int64)std::llround((double)gateMs * 0.001 * currentSampleRate));
+
     // Advance master beats accumulator once per block
     const double dtSec = (double)numSamples / currentSampleRate;
     const double prevBeats = masterBeatsAccum;
     if (run && spb > 0.0)
         masterBeatsAccum += dtSec / spb;
     const double currBeats = masterBeatsAccum;
-    const int timingMode = (int)std::round(apvts.getRawParameterValue("optTimingMode")->load());
+    const int timingMode = (int)std::round(timingModeParam->load());
     const double countModeCycleBeats = (double)kCountModeBaseBeats;
 
-    // --- Compute current poly-cycle (in beats), matching Export MIDI logic ---
-    int cycleLengthNumerator = 1;
-    int cycleLengthDenominator = 1;
-    bool hasCycleLength = false;
-    const int maxDen = 32;
+    // --- Refresh derived per-slot state flagged by the parameter listeners ---
+    bool recomputeCycle = cycleDirty.exchange(false, std::memory_order_acq_rel) || timingMode != lastTimingMode;
+    lastTimingMode = timingMode;
 
     for (int i = 0; i < kNumSlots; ++i)
     {
-        const bool mute = apvts.getRawParameterValue("slot" + juce::String(i + 1) + "_Mute")->load();
-        if (mute) continue;
-        if (anySolo && !soloMask[i]) continue;
-        if (!slots[i].hasSample()) continue;
+        auto& s = slots[i];
+        auto& derived = slotDerived[(size_t)i];
+        const auto& params = slotParams[(size_t)i];
+        auto& dirtyFlags = slotDirtyFlags[(size_t)i];
+        const uint32_t dirty = dirtyFlags.load(std::memory_order_relaxed) != 0
+            ? dirtyFlags.exchange(0, std::memory_order_acq_rel)
+            : 0u;
 
-        if (timingMode == 0)
+        if ((dirty & kDirtyPan) != 0)
+            s.setPan(params.pan->load());
+
+        if ((dirty & kDirtyDecay) != 0)
+            s.setDecayMs(decayUiToMilliseconds(params.decay->load()));
+
+        if ((dirty & kDirtyRate) != 0)
         {
-            const float rateF = *apvts.getRawParameterValue("slot" + juce::String(i + 1) + "_Rate");
-            const double rate = juce::jmax(0.0001f, rateF);
+            const double rate = juce::jmax(0.0001f, params.rate->load());
+            const int maxDen = 32;
 
             int num = 0, den = 1;
             approximateRational(rate, maxDen, num, den);
-            int g = igcd(num, den);
-            num /= g;
-            den /= g;
-            accumulateCycleLength(den, num, cycleLengthNumerator, cycleLengthDenominator, hasCycleLength);
+            const int g = igcd(num, den);
+            derived.rateNumerator = num / g;
+            derived.rateDenominator = den / g;
+            recomputeCycle = true;
         }
-        // Beats/Cycle mode does not alter the master cycle length
-    }
 
-    double cycleBeats = 1.0;
-    if (timingMode == 0)
-    {
-        if (!hasCycleLength)
+        // Sample loads and mute/solo changes alter which slots shape the cycle
+        const bool inCycle = params.mute->load() < 0.5f && (!anySolo || soloMask[i]) && s.hasSample();
+        if (inCycle != derived.inCycle)
         {
-            cycleLengthNumerator = 1;
-            cycleLengthDenominator = 1;
+            derived.inCycle = inCycle;
+            recomputeCycle = true;
         }
-
-        cycleBeats = juce::jlimit(1.0e-6, 512.0,
-            (double)cycleLengthNumerator / (double)cycleLengthDenominator);
     }
-    else
+
+    // --- Compute current poly-cycle (in beats), matching Export MIDI logic ---
+    if (recomputeCycle)
     {
-        cycleBeats = juce::jlimit(1.0e-6, 512.0, countModeCycleBeats);
+        if (timingMode == 0)
+        {
+            int cycleLengthNumerator = 1;
+            int cycleLengthDenominator = 1;
+            bool hasCycleLength = false;
+
+            for (const auto& derived : slotDerived)
+                if (derived.inCycle)
+                    accumulateCycleLength(derived.rateDenominator, derived.rateNumerator,
+                                          cycleLengthNumerator, cycleLengthDenominator, hasCycleLength);
+
+            if (!hasCycleLength)
+            {
+                cycleLengthNumerator = 1;
+                cycleLengthDenominator = 1;
+            }
+
+            cachedCycleBeats = juce::jlimit(1.0e-6, 512.0,
+                (double)cycleLengthNumerator / (double)cycleLengthDenominator);
+        }
+        else
+        {
+            // Beats/Cycle mode does not alter the master cycle length
+            cachedCycleBeats = juce::jlimit(1.0e-6, 512.0, countModeCycleBeats);
+        }
     }
 
+    const double cycleBeats = cachedCycleBeats;
+
     // Cache for editor
     currentCycleBeats = cycleBeats;
     if (currentCycleBeats > 0.0)
@@ -758,33 +1219,33 @@ void SlotMachineAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, j
         currentCyclePhase01 = 0.0;
 
     // Per-slot timing/render
+    numBlockHits = 0;
+
+    // Each live slot is charged the time since the previous live slot finished
+    const juce::int64 slotLoopStartTicks = LoadMeter::now();
+    juce::int64 slotStartTicks = slotLoopStartTicks;
+
     for (int i = 0; i < kNumSlots; ++i)
     {
         auto& s = slots[i];
 
-        const bool mute = apvts.getRawParameterValue("slot" + juce::String(i + 1) + "_Mute")->load();
+        const auto& params = slotParams[(size_t)i];
+
+        const bool mute = params.mute->load() >= 0.5f;
         const bool solo = soloMask[i];
         const bool slotAudible = !mute && (!anySolo || solo);
 
-        const float rate = *apvts.getRawParameterValue("slot" + juce::String(i + 1) + "_Rate");
+        const float rate = params.rate->load();
         int count = 4;
-        if (auto* countParam = apvts.getRawParameterValue("slot" + juce::String(i + 1) + "_Count"))
-            count = juce::jlimit(1, 64, (int)std::round(countParam->load()));
-        const float gainPercent = *apvts.getRawParameterValue("slot" + juce::String(i + 1) + "_Gain");
+        if (params.count != nullptr)
+            count = juce::jlimit(1, 64, (int)std::round(params.count->load()));
+        const float gainPercent = params.gain->load();
         const float gain = gainPercent * 0.01f;
-        const float pan = *apvts.getRawParameterValue("slot" + juce::String(i + 1) + "_Pan");
-        const float decayUi = *apvts.getRawParameterValue("slot" + juce::String(i + 1) + "_Decay");
-        const float decayMs = decayUiToMilliseconds(decayUi);
-        const auto* midiChoiceRaw = apvts.getRawParameterValue("slot" + juce::String(i + 1) + "_MidiChannel");
         int midiChoiceIndex = i;
-        if (midiChoiceRaw != nullptr)
-            midiChoiceIndex = juce::jlimit(0, 15, (int)std::round(midiChoiceRaw->load()));
+        if (params.midiChannel != nullptr)
+            midiChoiceIndex = juce::jlimit(0, 15, (int)std::round(params.midiChannel->load()));
 
         const int midiChannel = juce::jlimit(1, 16, midiChoiceIndex + 1);
-       
-
-        s.setPan(pan);
-        s.setDecayMs(decayMs);
 
         // Always keep visual phase tied to master beat phase (even if muted or idle)
         const double rateD = (double)rate;
@@ -807,66 +1268,93 @@ void SlotMachineAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, j
             // keep previous phase
         }
 
-        // --- manual click triggers (editor requests) ---
-        const int manualHits = pendingManualTriggers[(size_t)i].exchange(0, std::memory_order_relaxed);
-        if (manualHits > 0)
+        // Fire one hit: emit MIDI now and queue the voice retrigger for the block renderer
+        auto fireHit = [&](const PendingHit& hit)
         {
-            if (s.hasSample() && slotAudible)
+            if (numBlockHits < kMaxHitsPerBlock)
+                blockHits[(size_t)numBlockHits++] = { i, hit.offset, hit.velocityGain };
+            trace.record(AudioTrace::Type::hit, i, hit.offset);
+
+            // MIDI: emit note at exact in-block position; its note-off is scheduled on the
+            // absolute sample clock and may land in a later block
+            if (wantMidi && slotAudible)
             {
-                s.trigger();
-
-                if (wantMidi) {
-                    const int noteNumber = 60; // Middle C for all slots
-                    const int velocity = juce::jlimit(1, 127, (int)std::round(gain * 127.0f));
-                    const int onPos = 0;
-                    const int offPos = juce::jmin(numSamples - 1, (int)std::round(0.010 * currentSampleRate));
-                    midi.addEvent(juce::MidiMessage::noteOn(midiChannel, noteNumber, (juce::uint8)velocity), onPos);
-                    midi.addEvent(juce::MidiMessage::noteOff(midiChannel, noteNumber), offPos);
-                }
+                const int noteNumber = 60; // Middle C for all slots
+                const int velocity = juce::jlimit(1, 127, (int)std::round(gain * hit.velocityGain * 127.0f));
+
+                const juce::int64 onSample = engineSampleClock + hit.offset;
+                const auto noteOff = juce::MidiMessage::noteOff(midiChannel, noteNumber);
+
+                // Retriggering a note that is still held: close it first so the gate restarts cleanly
+                if (scheduledMidi.cancelNoteOff(midiChannel, noteNumber, onSample))
+                    midi.addEvent(noteOff, hit.offset);
 
-              
+                midi.addEvent(juce::MidiMessage::noteOn(midiChannel, noteNumber, (juce::uint8)velocity), hit.offset);
+
+                if (!scheduledMidi.schedule(onSample + gateSamples, noteOff))
+                    midi.addEvent(noteOff, numSamples - 1);
             }
+        };
+
+        // Empty slots only track phase for the UI; the rest of the block's work scales with live slots
+        if (!s.hasSample() && !s.tailActive && s.playIndex < 0)
+        {
+            s.pendingClickBeat = -1.0;
+            s.hitsDueNextBlock = 0;
+            s.wasAudibleLastBlock = slotAudible;
+            slotLive[(size_t)i] = false;
+            continue;
         }
 
+        slotLive[(size_t)i] = true;
+
         if (slotAudible && !s.wasAudibleLastBlock)
             s.stopImmediate();
 
-        // Render any currently ringing sample (works even when transport is stopped)
-        if (wantAudio)
-        {
-            const float mixGain = slotAudible ? gain : 0.0f;
-            s.mixInto(buffer, numSamples, mixGain);
-        }
+        // Ringing samples keep advancing (silently when muted) so unmuting never resumes a stale hit
+        slotMixGains[(size_t)i] = slotAudible ? gain : 0.0f;
 
-        // No processing if no sample or transport stopped (but visuals still update)
-        if (!s.hasSample() || !run || spb <= 0.0)
+        // Gather this block's hits: transport-scheduled ones plus MIDI-in and click triggers, fired in time order
+        auto& hits = slotHits;
+        int numHits = 0;
+        auto addHit = [&hits, &numHits, numSamples](int offset, float velocityGain)
         {
-            s.wasAudibleLastBlock = slotAudible;
-            continue;
-        }
+            if (numHits >= kMaxHitsPerSlotPerBlock)
+                return;
 
-        if (timingMode == 0)
+            hits[(size_t)numHits++] = { juce::jlimit(0, numSamples - 1, offset), velocityGain };
+        };
+
+        // Scheduled hits are rounded once, to the nearest sample of the engine clock. One that
+        // rounds onto the next block's first sample is played there rather than pulled back onto
+        // this block's last, so where block boundaries fall never moves a hit.
+        auto addScheduledHit = [&](double fracBlock)
         {
-            if (rateD <= 0.0)
-            {
-                s.wasAudibleLastBlock = slotAudible;
-                continue;
-            }
+            const int offset = (int)std::floor(fracBlock * (double)numSamples + 0.5);
+            if (offset >= numSamples)
+                ++s.hitsDueNextBlock;
+            else
+                addHit(offset, 1.0f);
+        };
 
-            // Render any currently ringing sample (only if Audio/Both and not muted/soloed out)
-            //if (wantAudio && !mute && (!anySolo || solo))
-            //    s.mixInto(buffer, numSamples, gain);
+        for (; s.hitsDueNextBlock > 0; --s.hitsDueNextBlock)
+            if (s.hasSample())
+                addHit(0, 1.0f);
 
-            // Compute how many slot-beats occur within this block
-            const double slotBeatsStart = prevBeats * rateD;
-            const double slotBeatsEnd = currBeats * rateD;
-            const double epsilon = 1e-9;
-            const int firstHitCount = (int)std::ceil(slotBeatsStart - epsilon);
-            const int endHitExclusive = (int)std::ceil(slotBeatsEnd - epsilon);
-            const int hitsThisBlock = juce::jmax(0, endHitExclusive - firstHitCount);
+        const bool scheduleHits = s.hasSample() && run && spb > 0.0;
 
-            if (hitsThisBlock > 0)
+        if (scheduleHits && timingMode == 0)
+        {
+            if (rateD > 0.0)
             {
+                // Compute how many slot-beats occur within this block
+                const double slotBeatsStart = prevBeats * rateD;
+                const double slotBeatsEnd = currBeats * rateD;
+                const double epsilon = 1e-9;
+                const int firstHitCount = (int)std::ceil(slotBeatsStart - epsilon);
+                const int endHitExclusive = (int)std::ceil(slotBeatsEnd - epsilon);
+                const int hitsThisBlock = juce::jmax(0, endHitExclusive - firstHitCount);
+
                 for (int h = 0; h < hitsThisBlock; ++h)
                 {
                     const double targetCount = (double)(firstHitCount + h);
@@ -878,140 +1366,307 @@ void SlotMachineAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, j
                         fracBlock = (targetCount - slotBeatsStart) / denom;
                     fracBlock = juce::jlimit(0.0, 1.0, fracBlock);
 
-                    const int hitOffset = juce::jlimit(0, numSamples - 1,
-                        (int)std::floor(fracBlock * (double)numSamples + 0.5));
-
-                    // Fire and mix from hit point to block end
-                    s.trigger();
-
-                    // MIDI: emit note at exact in-block position
-                    if (wantMidi && slotAudible)
-                    {
-                        const int noteNumber = 60; // Middle C for all slots
-                        const int velocity = juce::jlimit(1, 127, (int)std::round(gain * 127.0f));
-
-                        const int onPos = hitOffset;
-                        const int offPos = juce::jmin(numSamples - 1, hitOffset + (int)std::round(0.010 * currentSampleRate)); // ~10ms
-
-                        midi.addEvent(juce::MidiMessage::noteOn(midiChannel, noteNumber, (juce::uint8)velocity), onPos);
-                        midi.addEvent(juce::MidiMessage::noteOff(midiChannel, noteNumber), offPos);
-                    }
-
-                    // Audio: mix hit tail from the hit point forward (Audio/Both only)
-                    if (wantAudio)
-                    {
-                        const float mixGain = slotAudible ? gain : 0.0f;
-                        juce::AudioBuffer<float> view(buffer.getArrayOfWritePointers(),
-                            buffer.getNumChannels(),
-                            hitOffset,
-                            numSamples - hitOffset);
-                        s.mixInto(view, view.getNumSamples(), mixGain);
-                    }
+                    addScheduledHit(fracBlock);
                 }
             }
         }
-        else
+        else if (scheduleHits)
         {
             // --- BeatsPerCycle mode ---
             const double stepBeats = (count > 0 ? countModeCycleBeats / (double)count : 0.0);
             const double denomBeats = currBeats - prevBeats;
-            if (stepBeats <= 0.0 || denomBeats <= 0.0)
+            const uint64_t activeMask = getSlotCountMask(i) & maskForBeats(count);
+
+            if (stepBeats > 0.0 && denomBeats > 0.0 && activeMask != 0)
             {
-                s.wasAudibleLastBlock = slotAudible;
-                continue;
+                const int firstIndex = (int)std::ceil(prevBeats / stepBeats);
+                for (int n = firstIndex;; ++n)
+                {
+                    const double hitBeat = (double)n * stepBeats;
+                    if (hitBeat >= currBeats)
+                        break;
+
+                    const int beatIndex = (count > 0) ? (n % count) : 0;
+                    if (((activeMask >> beatIndex) & 1ull) == 0)
+                        continue;
+
+                    double fracBlock = (hitBeat - prevBeats) / denomBeats;
+                    fracBlock = juce::jlimit(0.0, 1.0, fracBlock);
+
+                    addScheduledHit(fracBlock);
+                }
             }
+        }
 
-            const uint64_t activeMask = getSlotCountMask(i) & maskForBeats(count);
-            if (activeMask == 0)
+        // Grid step used to quantise clicks, in master beats
+        double clickGridBeats = 0.0;
+        if (quantiseClicks && run && spb > 0.0)
+        {
+            if (timingMode == 0 && rateD > 0.0)
+                clickGridBeats = 1.0 / rateD;
+            else if (timingMode == 1 && count > 0)
+                clickGridBeats = countModeCycleBeats / (double)count;
+        }
+
+        const double blockBeats = currBeats - prevBeats;
+        auto beatToFraction = [&](double beat)
+        {
+            return (beat - prevBeats) / blockBeats;
+        };
+
+        // A quantised click from an earlier block whose grid line falls in this one
+        if (s.pendingClickBeat >= 0.0)
+        {
+            if (!s.hasSample() || !slotAudible)
+                s.pendingClickBeat = -1.0;
+            else if (clickGridBeats <= 0.0 || blockBeats <= 0.0)
             {
-                s.wasAudibleLastBlock = slotAudible;
-                continue;
+                addHit(0, 1.0f);
+                s.pendingClickBeat = -1.0;
             }
-
-            const int firstIndex = (int)std::ceil(prevBeats / stepBeats);
-            for (int n = firstIndex;; ++n)
+            else if (s.pendingClickBeat < currBeats)
             {
-                const double hitBeat = (double)n * stepBeats;
-                if (hitBeat >= currBeats)
-                    break;
+                addScheduledHit(beatToFraction(s.pendingClickBeat));
+                s.pendingClickBeat = -1.0;
+            }
+        }
 
-                const int beatIndex = (count > 0) ? (n % count) : 0;
-                if (((activeMask >> beatIndex) & 1ull) == 0)
+        // MIDI-in and click hits play live, independent of the transport, but only for audible slots
+        if (s.hasSample() && slotAudible)
+        {
+            for (int t = 0; t < numExternalTriggers; ++t)
+            {
+                const auto& trigger = externalTriggers[(size_t)t];
+                if (trigger.slot != i)
                     continue;
 
-                double fracBlock = (hitBeat - prevBeats) / denomBeats;
-                fracBlock = juce::jlimit(0.0, 1.0, fracBlock);
-
-                const int hitOffset = juce::jlimit(0, numSamples - 1,
-                    (int)std::floor(fracBlock * (double)numSamples + 0.5));
-
-                s.trigger();
-
-                if (wantMidi && slotAudible)
+                if (trigger.fromClick && clickGridBeats > 0.0 && blockBeats > 0.0)
                 {
-                    const int noteNumber = 60; // Middle C for all slots
-                    const int velocity = juce::jlimit(1, 127, (int)std::round(gain * 127.0f));
+                    // Snap to the next grid line at or after the click; it may belong to a later block
+                    const double clickBeat = prevBeats + blockBeats * (double)trigger.offset / (double)numSamples;
+                    const double gridBeat = std::ceil(clickBeat / clickGridBeats - 1.0e-9) * clickGridBeats;
 
-                    const int onPos = hitOffset;
-                    const int offPos = juce::jmin(numSamples - 1, hitOffset + (int)std::round(0.010 * currentSampleRate));
+                    if (gridBeat < currBeats)
+                        addScheduledHit(beatToFraction(gridBeat));
+                    else if (s.pendingClickBeat < 0.0 || gridBeat < s.pendingClickBeat)
+                        s.pendingClickBeat = gridBeat;
 
-                    midi.addEvent(juce::MidiMessage::noteOn(midiChannel, noteNumber, (juce::uint8)velocity), onPos);
-                    midi.addEvent(juce::MidiMessage::noteOff(midiChannel, noteNumber), offPos);
+                    continue;
                 }
 
-                if (wantAudio)
-                {
-                    const float mixGain = slotAudible ? gain : 0.0f;
-                    juce::AudioBuffer<float> view(buffer.getArrayOfWritePointers(),
-                        buffer.getNumChannels(),
-                        hitOffset,
-                        numSamples - hitOffset);
-                    s.mixInto(view, view.getNumSamples(), mixGain);
-                }
+                const float velocityGain = trigger.fromClick
+                    ? 1.0f
+                    : 1.0f - velocitySensitivity * (1.0f - trigger.velocity);
+                addHit(trigger.offset, velocityGain);
+            }
+        }
+
+        // Insertion sort keeps equal offsets in arrival order and never allocates
+        for (int h = 1; h < numHits; ++h)
+        {
+            const PendingHit key = hits[(size_t)h];
+            int j = h - 1;
+            while (j >= 0 && hits[(size_t)j].offset > key.offset)
+            {
+                hits[(size_t)j + 1] = hits[(size_t)j];
+                --j;
+            }
+            hits[(size_t)j + 1] = key;
+        }
+
+        for (int h = 0; h < numHits; ++h)
+        {
+            // Coinciding hits (e.g. a quantised click on a scheduled beat) fire once, at the louder velocity
+            if (h + 1 < numHits && hits[(size_t)h + 1].offset == hits[(size_t)h].offset)
+            {
+                hits[(size_t)h + 1].velocityGain = juce::jmax(hits[(size_t)h + 1].velocityGain, hits[(size_t)h].velocityGain);
+                continue;
             }
+
+            fireHit(hits[(size_t)h]);
         }
 
         s.wasAudibleLastBlock = slotAudible;
+
+        const juce::int64 slotEndTicks = LoadMeter::now();
+        engineTimes.slots[(size_t)i] += slotEndTicks - slotStartTicks;
+        slotStartTicks = slotEndTicks;
     }
 
-    if (wantAudio)
+    // Render every sounding voice (works even when transport is stopped). Hits are applied in
+    // time order, so sort them once for all groups.
+    for (int h = 1; h < numBlockHits; ++h)
     {
-        juce::SpinLock::ScopedTryLockType guard(previewLock);
-        if (guard.isLocked())
-            previewVoice.mixInto(buffer, numSamples);
+        const BlockHit key = blockHits[(size_t)h];
+        int j = h - 1;
+        while (j >= 0 && blockHits[(size_t)j].offset > key.offset)
+        {
+            blockHits[(size_t)j + 1] = blockHits[(size_t)j];
+            --j;
+        }
+        blockHits[(size_t)j + 1] = key;
     }
 
-    if (wantAudio && numSamples > 0)
+    numLiveGroups = 0;
+    for (int g = 0; g < kNumRenderGroups; ++g)
     {
-        if (scratchMono.getNumSamples() < numSamples)
-            scratchMono.setSize(1, numSamples, false, false, true);
+        for (int i = g * kSlotsPerRenderGroup; i < (g + 1) * kSlotsPerRenderGroup; ++i)
+        {
+            if (slotLive[(size_t)i])
+            {
+                liveGroups[(size_t)numLiveGroups++] = g;
+                break;
+            }
+        }
+    }
 
-        scratchMono.clear(0, 0, numSamples);
+    const juce::int64 mixStartTicks = LoadMeter::now();
+    engineTimes.sections[LoadMeter::slotScheduling] = mixStartTicks - slotLoopStartTicks;
 
-        auto* mono = scratchMono.getWritePointer(0);
-        const float* left  = buffer.getReadPointer(0);
-        const float* right = buffer.getNumChannels() > 1 ? buffer.getReadPointer(1) : nullptr;
+    // --- Frozen-cycle playback: only while the pattern and transport are untouched ---
+    const int numOutputChannels = juce::jmin(2, buffer.getNumChannels());
+    bool freezeEligible = freezeAvailable
+        && freezePatternsParam->load() >= 0.5f
+        && run && spb > 0.0
+        && numExternalTriggers == 0
+        && prevBeats == frozenBlockEndBeats
+        && numSamples <= frozenScratch.getNumSamples();
+    frozenBlockEndBeats = currBeats;
+
+    for (int i = 0; i < kNumSlots && freezeEligible; ++i)
+        freezeEligible = slots[(size_t)i].pendingClickBeat < 0.0;
+
+    if (!freezeEligible)
+    {
+        freezeState = FreezeState::live;
+        frozenPatternSignature = 0;
+    }
+    else
+    {
+        const uint64_t signature = computePatternSignature(numOutputChannels);
 
-        if (right != nullptr)
+        if (signature != frozenPatternSignature)
         {
-            for (int i = 0; i < numSamples; ++i)
-                mono[i] = 0.5f * (left[i] + right[i]);
+            // Wait for one unchanged block before capturing
+            freezeState = FreezeState::live;
+            frozenPatternSignature = signature;
         }
-        else if (left != nullptr)
+        else if (freezeState == FreezeState::live)
         {
-            juce::FloatVectorOperations::copy(mono, left, numSamples);
+            frozenLoopLength = findFrozenLoopLength(cycleBeats, spb);
+            frozenSamplesCaptured = 0;
+            if (frozenLoopLength > 0)
+                freezeState = FreezeState::capturing;
         }
+    }
 
-        int remaining = numSamples;
-        int offset = 0;
-        while (remaining > 0)
+    if (freezeState == FreezeState::playing)
+    {
+        // Voices still advance (and hits still retrigger them) so live rendering can resume at once
+        for (int n = 0; n < numLiveGroups; ++n)
+            renderSlotGroup(liveGroups[(size_t)n], nullptr, nullptr, numSamples);
+
+        playFrozenBlock(buffer, numSamples);
+    }
+    else if (freezeState == FreezeState::capturing)
+    {
+        frozenScratch.clear(0, numSamples);
+        renderVoices(frozenScratch.getWritePointer(0),
+                     numOutputChannels > 1 ? frozenScratch.getWritePointer(1) : nullptr, numSamples);
+
+        if (!captureFrozenBlock(numOutputChannels, numSamples))
+            freezeState = FreezeState::live;
+
+        for (int ch = 0; ch < numOutputChannels; ++ch)
+            buffer.addFrom(ch, 0, frozenScratch, ch, 0, numSamples);
+    }
+    else
+    {
+        renderVoices(buffer.getWritePointer(0),
+                     numOutputChannels > 1 ? buffer.getWritePointer(1) : nullptr, numSamples);
+    }
+
+    scheduledMidi.renderBlock(midi, engineSampleClock, numSamples);
+    engineSampleClock += numSamples;
+
+    if (wantAudio)
+        audition.process(buffer, numSamples);
+
+    const juce::int64 downmixStartTicks = LoadMeter::now();
+    engineTimes.sections[LoadMeter::voiceMixing] = downmixStartTicks - mixStartTicks;
+
+    // A group renders its slots' voices together, so its time is shared among its live slots
+    for (int n = 0; n < numLiveGroups; ++n)
+    {
+        const int g = liveGroups[(size_t)n];
+        const int firstSlot = g * kSlotsPerRenderGroup;
+        int numLive = 0;
+        for (int i = firstSlot; i < firstSlot + kSlotsPerRenderGroup; ++i)
+            numLive += slotLive[(size_t)i] ? 1 : 0;
+
+        for (int i = firstSlot; i < firstSlot + kSlotsPerRenderGroup; ++i)
+            if (slotLive[(size_t)i])
+                engineTimes.slots[(size_t)i] += groupRenderTicks[(size_t)g] / numLive;
+    }
+
+    if (wantAudio && numSamples > 0)
+    {
+        auto* mono = scratchMono.getWritePointer(0);
+        const float* left  = buffer.getReadPointer(0);
+        const float* right = buffer.getNumChannels() > 1 ? buffer.getReadPointer(1) : nullptr;
+
+        for (int offset = 0; offset < numSamples; offset += kScopeBlockSize)
         {
-            const int chunk = juce::jmin(remaining, kScopeBlockSize);
-            scopeQueue.push(mono + offset, chunk);
-            offset += chunk;
-            remaining -= chunk;
+            const int chunk = juce::jmin(kScopeBlockSize, numSamples - offset);
+
+            if (right != nullptr)
+            {
+                for (int i = 0; i < chunk; ++i)
+                    mono[i] = 0.5f * (left[offset + i] + right[offset + i]);
+            }
+            else if (left != nullptr)
+            {
+                juce::FloatVectorOperations::copy(mono, left + offset, chunk);
+            }
+
+            scopeQueue.push(mono, chunk);
         }
     }
+
+    engineTimes.sections[LoadMeter::scopeDownmix] = LoadMeter::now() - downmixStartTicks;
+
+    publishTelemetry(buffer, numSamples);
+}
+
+// Engine thread, once per block. Hits may have been counted on render workers, which have
+// all finished by the time the block ends.
+void SlotMachineAudioProcessor::publishTelemetry(const juce::AudioBuffer<float>& buffer, int numSamples) noexcept
+{
+    auto& t = telemetry.write();
+    t.blockIndex = ++telemetryBlockIndex;
+    t.cyclePhase = currentCyclePhase01;
+    t.cycleBeats = currentCycleBeats;
+    t.activeVoices = 0;
+
+    for (int i = 0; i < kNumSlots; ++i)
+    {
+        const auto& s = slots[(size_t)i];
+        const bool playing = s.playIndex >= 0;
+        const int voices = (playing ? 1 : 0) + (s.tailActive ? 1 : 0);
+
+        t.slotPhases[(size_t)i] = s.phase;
+        t.hitCounters[(size_t)i] = s.hitCounter;
+        t.slotVoices[(size_t)i] = (uint8_t)voices;
+        t.slotLevels[(size_t)i] = playing ? s.env * s.hitGain * slotMixGains[(size_t)i] : 0.0f;
+        t.activeVoices += voices;
+    }
+
+    for (int ch = 0; ch < (int)t.outputPeak.size(); ++ch)
+        t.outputPeak[(size_t)ch] = ch < buffer.getNumChannels() && numSamples > 0
+            ? buffer.getMagnitude(ch, 0, numSamples)
+            : 0.0f;
+
+    telemetry.publish();
 }
 
 //==============================================================================
@@ -1055,8 +1710,8 @@ void SlotMachineAudioProcessor::getStateInformation(juce::MemoryBlock& destData)
     for (int i = 0; i < kNumSlots; ++i)
     {
         juce::Identifier prop("slot" + juce::String(i + 1) + "_File");
-        if (slots[i].getFilePath().isNotEmpty())
-            apvts.state.setProperty(prop, slots[i].getFilePath(), nullptr);
+        if (slotSampleInfo[(size_t)i].filePath.isNotEmpty())
+            apvts.state.setProperty(prop, slotSampleInfo[(size_t)i].filePath, nullptr);
         else
             apvts.state.removeProperty(prop, nullptr);
     }
@@ -1086,6 +1741,7 @@ void SlotMachineAudioProcessor::setStateInformation(const void* data, int sizeIn
         apvts.replaceState(juce::ValueTree::fromXml(*xml));
         upgradeLegacySlotParameters();
         refreshSlotCountMasksFromState();
+        markAllDerivedStateDirty();
 
         // Each new session should start from a blank state regardless of what was stored in the
         // host project.  Force the first editor to reinitialise the processor to its defaults and
@@ -1124,19 +1780,25 @@ void SlotMachineAudioProcessor::resetAllPhases(bool immediate)
 bool SlotMachineAudioProcessor::slotHasSample(int index) const
 {
     jassert(juce::isPositiveAndBelow(index, kNumSlots));
-    return slots[(size_t)index].hasSample();
+    return slotSampleInfo[(size_t)index].loaded;
 }
 
 juce::String SlotMachineAudioProcessor::getSlotFilePath(int index) const
 {
     jassert(juce::isPositiveAndBelow(index, kNumSlots));
-    return slots[(size_t)index].getFilePath();
+    return slotSampleInfo[(size_t)index].filePath;
+}
+
+SampleAnalysis SlotMachineAudioProcessor::getSlotSampleAnalysis(int index) const
+{
+    jassert(juce::isPositiveAndBelow(index, kNumSlots));
+    return slotSampleInfo[(size_t)index].analysis;
 }
 
 void SlotMachineAudioProcessor::setSlotFilePath(int index, const juce::String& path)
 {
     jassert(juce::isPositiveAndBelow(index, kNumSlots));
-    slots[(size_t)index].setFilePath(path);
+    slotSampleInfo[(size_t)index].filePath = path;
     apvts.state.setProperty("slot" + juce::String(index + 1) + "_File", path, nullptr);
 }
 
@@ -1165,16 +1827,22 @@ void SlotMachineAudioProcessor::refreshSlotCountMasksFromState()
 bool SlotMachineAudioProcessor::loadSampleForSlot(int index, const juce::File& f, bool allowTail)
 {
     jassert(juce::isPositiveAndBelow(index, kNumSlots));
-    slots[(size_t)index].clear(allowTail);
+    auto& info = slotSampleInfo[(size_t)index];
+    info = {};
 
-    slots[(size_t)index].loadFile(f);
+    StoredSample sample;
+    info.loaded = acquireFileSample(*sampleMemory, f, currentSampleRate, getSampleStorageFormat(), sample, info.analysis);
+    trace.record(AudioTrace::Type::sampleLoaded, index, sample.getNumSamples());
+    publishSlotSample(index, std::move(sample), allowTail);
 
-    if (slots[(size_t)index].hasSample())
+    if (info.loaded)
     {
+        info.filePath = f.getFullPathName();
         apvts.state.setProperty("slot" + juce::String(index + 1) + "_File", f.getFullPathName(), nullptr);
         return true;
     }
 
+    info.analysis = {};
     apvts.state.removeProperty("slot" + juce::String(index + 1) + "_File", nullptr);
     return false;
 }
@@ -1184,62 +1852,106 @@ bool SlotMachineAudioProcessor::loadSampleForSlotFromMemory(int index, const voi
     if (!juce::isPositiveAndBelow(index, kNumSlots) || data == nullptr || sizeBytes <= 0)
         return false;
 
-    auto& slot = slots[(size_t)index];
+    auto& info = slotSampleInfo[(size_t)index];
+    info = {};
     const bool allowTail = apvts.getRawParameterValue("masterRun")->load();
-    slot.clear(allowTail);
 
-    juce::AudioFormatManager fm;
-    fm.registerBasicFormats();
+    StoredSample sample;
+    info.loaded = acquireMemorySample(*sampleMemory, data, sizeBytes, pseudoName, currentSampleRate,
+        getSampleStorageFormat(), sample, info.analysis);
+    trace.record(AudioTrace::Type::sampleLoaded, index, sample.getNumSamples());
+    publishSlotSample(index, std::move(sample), allowTail);
 
-    auto reader = makeReaderFromMemory(fm, data, sizeBytes);
+    if (info.loaded)
+        info.filePath = pseudoName;
+    else
+        info.analysis = {};
 
-    if (reader == nullptr)
-    {
-        slot.setFilePath({});
-        apvts.state.removeProperty("slot" + juce::String(index + 1) + "_File", nullptr);
-        return false;
-    }
+    apvts.state.removeProperty("slot" + juce::String(index + 1) + "_File", nullptr);
+
+    return info.loaded;
+}
 
-    juce::AudioBuffer<float> decoded;
-    if (!decodeReaderToStereoBuffer(*reader, slot.sampleRate, decoded))
+// Message thread: queues sample (empty to clear the slot) for the engine, replacing one it has
+// not taken yet. Waits only while the engine is in the middle of taking the previous one.
+void SlotMachineAudioProcessor::publishSlotSample(int index, StoredSample sample, bool allowTail)
+{
+    auto& handoff = sampleHandoffs[(size_t)index];
+
+    for (;;)
     {
-        slot.setFilePath({});
-        apvts.state.removeProperty("slot" + juce::String(index + 1) + "_File", nullptr);
-        return false;
+        int expected = SampleHandoff::kFree;
+        if (handoff.state.compare_exchange_strong(expected, SampleHandoff::kClaimed, std::memory_order_acquire))
+            break;
+
+        expected = SampleHandoff::kReady;
+        if (handoff.state.compare_exchange_strong(expected, SampleHandoff::kClaimed, std::memory_order_acquire))
+            break;
+
+        juce::Thread::yield();
     }
 
-    slot.sample = std::move(decoded);
-    slot.active = (slot.sample.getNumSamples() > 0);
-    slot.filePath = pseudoName;
-    slot.playIndex = -1;
-    slot.playLength = slot.sample.getNumSamples();
-    slot.env = 0.0f;
-    slot.envSamplesElapsed = 0;
-    slot.envMaxSamples = 0;
+    // Whatever the engine left behind, and a superseded sample it never took, are dropped here
+    for (auto& unreleased : handoff.unreleased)
+        unreleased.reset();
 
-    apvts.state.removeProperty("slot" + juce::String(index + 1) + "_File", nullptr);
+    handoff.sample = std::move(sample);
+    handoff.allowTail = allowTail;
+    handoff.state.store(SampleHandoff::kReady, std::memory_order_release);
 
-    return slot.hasSample();
+    invalidateFrozenCycle();
 }
 
-void SlotMachineAudioProcessor::previewEmbeddedWav(const void* data, int sizeBytes)
+// Engine, before anything reads the slots: swaps in every published sample
+void SlotMachineAudioProcessor::takePendingSamples() noexcept
 {
-    if (data == nullptr || sizeBytes <= 0)
-        return;
+    for (int i = 0; i < kNumSlots; ++i)
+    {
+        auto& handoff = sampleHandoffs[(size_t)i];
 
-    juce::AudioFormatManager fm;
-    fm.registerBasicFormats();
+        int expected = SampleHandoff::kReady;
+        if (!handoff.state.compare_exchange_strong(expected, SampleHandoff::kTaking, std::memory_order_acquire))
+            continue;
 
-    auto reader = makeReaderFromMemory(fm, data, sizeBytes);
-    if (reader == nullptr)
-        return;
+        slots[(size_t)i].replaceSample(handoff.sample, handoff.allowTail, handoff.unreleased);
+        handoff.state.store(SampleHandoff::kFree, std::memory_order_release);
+    }
+}
 
-    juce::AudioBuffer<float> decoded;
-    if (!decodeReaderToStereoBuffer(*reader, currentSampleRate, decoded))
-        return;
+// Returns at once: the audition engine's loader thread fetches the sample and the audio thread starts it
+void SlotMachineAudioProcessor::previewEmbeddedWav(const juce::String& resourceName)
+{
+    audition.audition(embeddedAuditionSource(resourceName));
+}
+
+void SlotMachineAudioProcessor::prefetchEmbeddedWavs(const juce::StringArray& resourceNames)
+{
+    std::vector<AuditionEngine::Source> sources;
+    for (const auto& name : resourceNames)
+    {
+        auto source = embeddedAuditionSource(name);
+        if (source.data != nullptr && source.sizeBytes > 0)
+            sources.push_back(std::move(source));
+    }
+
+    audition.prefetch(sources);
+}
+
+// Audition engine loader thread. Goes through the sample cache in the slots' storage format, so
+// picking an auditioned sample for a slot finds it already decoded.
+bool SlotMachineAudioProcessor::loadAuditionSample(const AuditionEngine::Source& source, double rate, StoredSample& sample)
+{
+    auto decode = [&source, rate](juce::AudioBuffer<float>& decoded, SampleAnalysis& decodedAnalysis)
+    {
+        juce::AudioFormatManager fm;
+        fm.registerBasicFormats();
+        auto reader = makeReaderFromMemory(fm, source.data, source.sizeBytes);
+        return reader != nullptr && decodeReaderToStereoBuffer(*reader, rate, decoded, &decodedAnalysis);
+    };
 
-    const juce::SpinLock::ScopedLockType lock(previewLock);
-    previewVoice.start(std::move(decoded));
+    SampleAnalysis analysis;
+    return sampleMemory->acquire(memorySourceId(source.name, source.data, source.sizeBytes), 0, rate,
+        getSampleStorageFormat(), decode, sample, analysis);
 }
 
 juce::ValueTree SlotMachineAudioProcessor::copyStateWithVersion()
@@ -1396,7 +2108,8 @@ void SlotMachineAudioProcessor::upgradeLegacySlotParameters()
 void SlotMachineAudioProcessor::clearSlot(int index, bool allowTail)
 {
     jassert(juce::isPositiveAndBelow(index, kNumSlots));
-    slots[(size_t)index].clear(allowTail);
+    slotSampleInfo[(size_t)index] = {};
+    publishSlotSample(index, {}, allowTail);
     apvts.state.removeProperty("slot" + juce::String(index + 1) + "_File", nullptr);
 }
 
@@ -1406,12 +2119,6 @@ void SlotMachineAudioProcessor::clearAllSlots()
         clearSlot(i);
 }
 
-uint32_t SlotMachineAudioProcessor::getSlotHitCounter(int index) const
-{
-    jassert(juce::isPositiveAndBelow(index, kNumSlots));
-    return slots[(size_t)index].hitCounter;
-}
-
 uint64_t SlotMachineAudioProcessor::getSlotCountMask(int index) const
 {
     if (!juce::isPositiveAndBelow(index, kNumSlots))
@@ -1444,29 +2151,6 @@ uint64_t SlotMachineAudioProcessor::maskForBeats(int beats)
     return (1ull << beats) - 1ull;
 }
 
-double SlotMachineAudioProcessor::getSlotPhase(int index) const
-{
-    jassert(juce::isPositiveAndBelow(index, kNumSlots));
-    return slots[(size_t)index].phase;
-}
-
-double SlotMachineAudioProcessor::getMasterPhase() const
-{
-    // Averages slot phases that have samples; returns 0 if none
-    //double sum = 0.0;
-    //int count = 0;
-    //for (int i = 0; i < kNumSlots; ++i)
-    //{
-    //    if (slots[i].hasSample())
-    //    {
-    //        sum += slots[i].phase;
-    //        ++count;
-    //    }
-    //}
-    //return count > 0 ? sum / count : 0.0;
-    return currentCyclePhase01; // 0..1 over the full polyrhythmic cycle
-}
-
 bool SlotMachineAudioProcessor::exportAudioCycles(const juce::File& destination, int cyclesToExport, juce::String& errorMessage)
 {
     errorMessage.clear();
@@ -1553,7 +2237,7 @@ bool SlotMachineAudioProcessor::exportAudioCycles(const juce::File& destination,
             {
                 if (resourceSize > 0)
                 {
-                    voice.loadFromMemory(data, resourceSize, path);
+                    voice.loadFromMemory(data, resourceSize, path, *sampleMemory, getSampleStorageFormat());
                     loaded = voice.hasSample();
                 }
             }
@@ -1570,7 +2254,7 @@ bool SlotMachineAudioProcessor::exportAudioCycles(const juce::File& destination,
                 continue;
             }
 
-            voice.loadFile(audioFile);
+            voice.loadFile(audioFile, *sampleMemory, getSampleStorageFormat());
             loaded = voice.hasSample();
             missingIdentifier = audioFile.getFullPathName();
         }
@@ -1758,16 +2442,23 @@ bool SlotMachineAudioProcessor::exportAudioCycles(const juce::File& destination,
     juce::AudioBuffer<float> renderBuffer(numChannels, totalSamplesNeeded);
     renderBuffer.clear();
 
+    // As in the engine, a slot has one voice: a hit restarts it and cuts off the one before
     for (auto& slot : slotsToRender)
     {
-        for (int triggerSample : slot.triggers)
+        std::sort(slot.triggers.begin(), slot.triggers.end());
+
+        for (size_t t = 0; t < slot.triggers.size(); ++t)
         {
+            const int triggerSample = slot.triggers[t];
             if (triggerSample < 0 || triggerSample >= totalSamplesNeeded)
                 continue;
 
             slot.voice.trigger();
 
-            const int remaining = totalSamplesNeeded - triggerSample;
+            const int voiceEnd = t + 1 < slot.triggers.size()
+                ? juce::jmin(totalSamplesNeeded, slot.triggers[t + 1])
+                : totalSamplesNeeded;
+            const int remaining = voiceEnd - triggerSample;
             if (remaining <= 0)
                 continue;
 
@@ -1990,7 +2681,7 @@ void SlotMachineAudioProcessor::storeCurrentStateInPattern(juce::ValueTree patte
         }
 
         const juce::String fileId = slotParamId(slot, "File");
-        pattern.setProperty(fileId, slots[(size_t)slot].getFilePath(), nullptr);
+        pattern.setProperty(fileId, slotSampleInfo[(size_t)slot].filePath, nullptr);
 
         const juce::String maskId = slotParamId(slot, "CountMask");
         pattern.setProperty(maskId, apvts.state.getProperty(maskId), nullptr);
@@ -2005,6 +2696,8 @@ void SlotMachineAudioProcessor::applyPatternTree(const juce::ValueTree& pattern,
     if (!pattern.isValid())
         return;
 
+    trace.record(AudioTrace::Type::patternSwapStart);
+
     if (auto* masterParam = dynamic_cast<juce::AudioParameterFloat*>(apvts.getParameter("masterBPM")))
     {
         const auto valueVar = pattern.getProperty(kPatternMasterBpmProperty);
@@ -2125,6 +2818,8 @@ void SlotMachineAudioProcessor::applyPatternTree(const juce::ValueTree& pattern,
             clearSlot(slot, allowTailRelease);
         }
     }
+
+    trace.record(AudioTrace::Type::patternSwapEnd);
 }
 
 void SlotMachineAudioProcessor::setCurrentPatternIndex(int index)
@@ -2152,84 +2847,609 @@ juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter()
 void SlotMachineAudioProcessor::SlotVoice::setDecayMs(float ms)
 {
     if (ms <= 0.0f || sampleRate <= 0.0)
-    { envAlpha = 1.0f; envMaxSamples = 0; return; }
-    const double samples = (ms / 1000.0) * sampleRate;
-    envMaxSamples = (int) std::round(samples);
-    envAlpha = (float) std::pow(0.001, 1.0 / juce::jmax(1.0, samples));
+    {
+        envAlpha = 1.0f; envMaxSamples = 0;
+    }
+    else
+    {
+        const double samples = (ms / 1000.0) * sampleRate;
+        envMaxSamples = (int) std::round(samples);
+        envAlpha = (float) std::pow(0.001, 1.0 / juce::jmax(1.0, samples));
+    }
+
+    // A ringing voice picks up the new decay, so its end moves with it
+    if (playIndex >= 0)
+        playLength = findSilentEnd(playIndex, sample.getNumSamples(), env, envAlpha);
 }
 
-void SlotMachineAudioProcessor::PreviewVoice::reset() noexcept
+void SlotMachineAudioProcessor::updateVoiceBankGains(int slotIndex) noexcept
 {
-    playIndex = -1;
-    playLength = 0;
-    env = 0.0f;
-    envAlpha = 1.0f;
-    envSamplesElapsed = 0;
-    envMaxSamples = 0;
-    sample.setSize(0, 0);
+    const auto& s = slots[(size_t)slotIndex];
+    auto& bank = voiceBanks[(size_t)(slotIndex / kSlotsPerRenderGroup)];
+    const int lane = (slotIndex % kSlotsPerRenderGroup) * 2;
+    const float gain = slotMixGains[(size_t)slotIndex];
+    const float voiceGain = gain * s.hitGain;
+    const float tailGain = gain * s.tailHitGain;
+
+    bank.setGains(lane, voiceGain * s.panL, voiceGain * s.panR, voiceGain);
+    bank.setGains(lane + 1, tailGain * s.tailPanL, tailGain * s.tailPanR, tailGain);
 }
 
-void SlotMachineAudioProcessor::PreviewVoice::start(juce::AudioBuffer<float> newSample) noexcept
+size_t SlotMachineAudioProcessor::getSampleMemoryBudgetBytes() const noexcept
 {
-    sample = std::move(newSample);
-    playLength = sample.getNumSamples();
-    playIndex = (playLength > 0) ? 0 : -1;
-    env = 1.0f;
-    envSamplesElapsed = 0;
-    envMaxSamples = playLength;
+    return (size_t)juce::jmax(1, juce::roundToInt(sampleMemoryParam->load())) * 1024 * 1024;
+}
 
-    if (envMaxSamples > 0)
-        envAlpha = (float)std::pow(0.001, 1.0 / (double)envMaxSamples);
-    else
-        envAlpha = 1.0f;
+SampleMemoryManager::Usage SlotMachineAudioProcessor::getSampleMemoryUsage()
+{
+    return sampleMemory->getUsage();
 }
 
-void SlotMachineAudioProcessor::PreviewVoice::mixInto(juce::AudioBuffer<float>& buffer, int numSamples) noexcept
+StoredSample::Format SlotMachineAudioProcessor::getSampleStorageFormat() const noexcept
 {
-    if (playIndex < 0 || playLength <= 0)
-        return;
+    switch (juce::roundToInt(sampleStorageParam->load()))
+    {
+        case 1:  return StoredSample::Format::int16;
+        case 2:  return StoredSample::Format::float16;
+        default: return StoredSample::Format::float32;
+    }
+}
+
+void SlotMachineAudioProcessor::startVoiceBankLane(int slotIndex) noexcept
+{
+    const auto& s = slots[(size_t)slotIndex];
+    auto& bank = voiceBanks[(size_t)(slotIndex / kSlotsPerRenderGroup)];
+    const int lane = (slotIndex % kSlotsPerRenderGroup) * 2;
 
-    const int remaining = playLength - playIndex;
-    if (remaining <= 0)
+    if (s.playIndex < 0 || s.playLength <= 0 || s.sample.getNumSamples() <= 0)
     {
-        reset();
+        bank.stop(lane);
         return;
     }
 
-    const int toProcess = juce::jmin(numSamples, remaining);
-    auto* dstL = buffer.getWritePointer(0);
-    auto* dstR = buffer.getNumChannels() > 1 ? buffer.getWritePointer(1) : nullptr;
+    bank.start(lane, s.sample.getFormat(), s.sample.getScale(),
+        s.sample.getChannel(0), s.sample.getChannel(1),
+        s.playIndex, juce::jmin(s.playLength, s.sample.getNumSamples()),
+        s.env, s.envAlpha, s.envSamplesElapsed);
+    updateVoiceBankGains(slotIndex);
+}
+
+void SlotMachineAudioProcessor::loadVoiceBank(int group) noexcept
+{
+    auto& bank = voiceBanks[(size_t)group];
+    bank.clear();
+
+    for (int i = group * kSlotsPerRenderGroup; i < (group + 1) * kSlotsPerRenderGroup; ++i)
+    {
+        if (!slotLive[(size_t)i])
+            continue;
+
+        const auto& s = slots[(size_t)i];
+        startVoiceBankLane(i);
+
+        if (s.tailActive && s.tailIndex >= 0 && s.tailSample.getNumSamples() > 0)
+        {
+            bank.start((i % kSlotsPerRenderGroup) * 2 + 1, s.tailSample.getFormat(), s.tailSample.getScale(),
+                s.tailSample.getChannel(0), s.tailSample.getChannel(1),
+                s.tailIndex, juce::jmin(s.tailLength, s.tailSample.getNumSamples()),
+                s.tailEnv, s.tailEnvAlpha, s.tailEnvSamplesElapsed);
+        }
+
+        updateVoiceBankGains(i);
+    }
+}
+
+void SlotMachineAudioProcessor::storeVoiceBank(int group) noexcept
+{
+    const auto& bank = voiceBanks[(size_t)group];
+
+    for (int i = group * kSlotsPerRenderGroup; i < (group + 1) * kSlotsPerRenderGroup; ++i)
+    {
+        if (!slotLive[(size_t)i])
+            continue;
+
+        auto& s = slots[(size_t)i];
+        const int lane = (i % kSlotsPerRenderGroup) * 2;
+
+        if (bank.isActive(lane))
+        {
+            s.playIndex = bank.getPlayIndex(lane);
+            s.env = bank.getEnvelope(lane);
+            s.envSamplesElapsed = bank.getEnvSamplesElapsed(lane);
+        }
+        else
+        {
+            if (s.playIndex >= 0)
+                trace.record(AudioTrace::Type::voiceEnd, i);
+            s.playIndex = -1;
+        }
+
+        if (bank.isActive(lane + 1))
+        {
+            s.tailIndex = bank.getPlayIndex(lane + 1);
+            s.tailEnv = bank.getEnvelope(lane + 1);
+            s.tailEnvSamplesElapsed = bank.getEnvSamplesElapsed(lane + 1);
+        }
+        else if (s.tailActive)
+        {
+            s.releaseTail();
+        }
+    }
+}
+
+// Renders one group's voices for the block, splitting at that group's hits so retriggers land
+// on their exact sample. Groups share no state, so they may run on different threads. A null
+// destination advances the voices without mixing them.
+void SlotMachineAudioProcessor::renderSlotGroup(int group, float* dstL, float* dstR, int numSamples) noexcept
+{
+    const juce::int64 startTicks = LoadMeter::now();
+    auto& bank = voiceBanks[(size_t)group];
+    const int firstSlot = group * kSlotsPerRenderGroup;
+    int renderedTo = 0;
+
+    auto renderUpTo = [&](int end)
+    {
+        if (end > renderedTo && dstL == nullptr)
+            bank.advance(end - renderedTo);
+        else if (end > renderedTo)
+            bank.render(dstL + renderedTo, dstR != nullptr ? dstR + renderedTo : nullptr, end - renderedTo);
+        renderedTo = juce::jmax(renderedTo, end);
+    };
+
+    loadVoiceBank(group);
+
+    for (int h = 0; h < numBlockHits; ++h)
+    {
+        const auto& hit = blockHits[(size_t)h];
+        if (hit.slot < firstSlot || hit.slot >= firstSlot + kSlotsPerRenderGroup)
+            continue;
+
+        renderUpTo(hit.offset);
+
+        auto& slot = slots[(size_t)hit.slot];
+        if (slot.hasSample())
+        {
+            if (bank.isActive((hit.slot % kSlotsPerRenderGroup) * 2))
+                trace.record(AudioTrace::Type::voiceSteal, hit.slot, hit.offset);
+            trace.record(AudioTrace::Type::voiceStart, hit.slot, hit.offset);
+        }
+
+        slot.trigger(hit.velocityGain);
+        startVoiceBankLane(hit.slot);
+    }
+
+    renderUpTo(numSamples);
+    storeVoiceBank(group);
+
+    groupRenderTicks[(size_t)group] = LoadMeter::now() - startTicks;
+}
+
+void SlotMachineAudioProcessor::renderSlotGroupTask(void* context, int taskIndex, int workerIndex) noexcept
+{
+    auto& self = *static_cast<SlotMachineAudioProcessor*>(context);
+    const int numSamples = self.renderTaskNumSamples;
+    float* dstL = self.renderTaskDstL;
+    float* dstR = self.renderTaskDstR;
+
+    if (workerIndex > 0)
+    {
+        // Pool threads render into their own scratch; the audio thread writes straight to the output
+        auto& scratch = self.renderScratch[(size_t)workerIndex];
+        if (!self.renderScratchUsed[(size_t)workerIndex])
+        {
+            scratch.clear(0, numSamples);
+            self.renderScratchUsed[(size_t)workerIndex] = true;
+        }
+
+        dstL = scratch.getWritePointer(0);
+        dstR = dstR != nullptr ? scratch.getWritePointer(1) : nullptr;
+    }
+
+    self.renderSlotGroup(self.liveGroups[(size_t)taskIndex], dstL, dstR, numSamples);
+}
 
-    const float* srcL = sample.getReadPointer(0, playIndex);
-    const float* srcR = (sample.getNumChannels() > 1) ? sample.getReadPointer(1, playIndex) : nullptr;
+// Adds every live group's voices to dst, spreading groups over the worker pool only when the
+// block is long enough to repay the hand-off
+void SlotMachineAudioProcessor::renderVoices(float* dstL, float* dstR, int numSamples) noexcept
+{
+    const bool renderInParallel = parallelRenderParam->load() >= 0.5f
+        && renderPool.getNumWorkers() > 0
+        && numLiveGroups > 1
+        && numSamples >= kMinParallelRenderBlock
+        && numSamples <= renderScratch[0].getNumSamples();
 
-    if (srcL == nullptr)
+    if (!renderInParallel)
     {
-        reset();
+        for (int n = 0; n < numLiveGroups; ++n)
+            renderSlotGroup(liveGroups[(size_t)n], dstL, dstR, numSamples);
         return;
     }
 
-    for (int i = 0; i < toProcess; ++i)
+    renderTaskDstL = dstL;
+    renderTaskDstR = dstR;
+    renderTaskNumSamples = numSamples;
+    renderScratchUsed.fill(false);
+
+    renderPool.run(numLiveGroups, &SlotMachineAudioProcessor::renderSlotGroupTask, this);
+
+    for (int w = 1; w <= renderPool.getNumWorkers(); ++w)
     {
-        const float currentEnv = env;
-        if (dstL != nullptr)
-            dstL[i] += srcL[i] * currentEnv;
+        if (!renderScratchUsed[(size_t)w])
+            continue;
+
+        juce::FloatVectorOperations::add(dstL, renderScratch[(size_t)w].getReadPointer(0), numSamples);
         if (dstR != nullptr)
+            juce::FloatVectorOperations::add(dstR, renderScratch[(size_t)w].getReadPointer(1), numSamples);
+    }
+}
+
+// Emits at offset 0 the note-offs a re-prepare left pending, so no note sent before it hangs.
+// Added ahead of the block's own events, a flushed note-off never cuts a note starting at 0.
+void SlotMachineAudioProcessor::flushNoteOffsLeftByPrepare(juce::MidiBuffer& midi) noexcept
+{
+    if (!flushScheduledMidi)
+        return;
+
+    scheduledMidi.flushAll(midi, 0);
+    flushScheduledMidi = false;
+}
+
+// True while any slot voice or tail is still audible, a hit is due at the start of the next
+// block, or an audition is playing
+bool SlotMachineAudioProcessor::isAnyVoiceSounding() noexcept
+{
+    for (const auto& s : slots)
+        if (s.playIndex >= 0 || s.tailActive || s.hitsDueNextBlock > 0)
+            return true;
+
+    return audition.isSounding();
+}
+
+// Hash of everything that shapes the voices' output. Equal signatures on consecutive blocks
+// mean the pattern has not been touched in between.
+uint64_t SlotMachineAudioProcessor::computePatternSignature(int numOutputChannels) const noexcept
+{
+    uint64_t hash = 14695981039346656037ull; // FNV-1a
+    auto mix = [&hash](uint64_t value)
+    {
+        for (int b = 0; b < 8; ++b)
+        {
+            hash ^= (value >> (b * 8)) & 0xffu;
+            hash *= 1099511628211ull;
+        }
+    };
+    auto mixFloat = [&mix](const std::atomic<float>* param)
+    {
+        uint32_t bits = 0;
+        if (param != nullptr)
+        {
+            const float value = param->load(std::memory_order_relaxed);
+            std::memcpy(&bits, &value, sizeof(bits));
+        }
+        mix(bits);
+    };
+
+    mixFloat(masterBpmParam);
+    mixFloat(timingModeParam);
+    mix((uint64_t)numOutputChannels);
+    mix(patternEditCounter.load(std::memory_order_acquire));
+
+    for (int i = 0; i < kNumSlots; ++i)
+    {
+        const auto& params = slotParams[(size_t)i];
+        const auto& s = slots[(size_t)i];
+
+        mixFloat(params.mute);
+        mixFloat(params.solo);
+        mixFloat(params.rate);
+        mixFloat(params.count);
+        mixFloat(params.gain);
+        mixFloat(params.pan);
+        mixFloat(params.decay);
+        mix(countBeatMasks[(size_t)i].load(std::memory_order_relaxed));
+        mix((uint64_t)(juce::pointer_sized_uint)s.sample.getChannel(0));
+        mix((uint64_t)s.sample.getNumSamples() << 1 | (s.active ? 1u : 0u));
+    }
+
+    return hash;
+}
+
+// Smallest whole number of poly-cycles that spans a whole number of samples and fits the loop
+// buffer; 0 if there is none (the output is then not sample-periodic at this tempo).
+int SlotMachineAudioProcessor::findFrozenLoopLength(double cycleBeats, double secondsPerBeat) const noexcept
+{
+    const double samplesPerCycle = cycleBeats * secondsPerBeat * currentSampleRate;
+    const int maxLength = frozenLoop.getNumSamples();
+
+    if (samplesPerCycle < 1.0)
+        return 0;
+
+    for (int cycles = 1; samplesPerCycle * (double)cycles <= (double)maxLength; ++cycles)
+    {
+        const double length = samplesPerCycle * (double)cycles;
+        if (std::abs(length - std::round(length)) < 1.0e-6)
+            return (int)std::round(length);
+    }
+
+    return 0;
+}
+
+// Records the first loop of frozenScratch output, then compares the second loop against it.
+// Returns false on a mismatch; switches to playback once a whole loop has matched.
+bool SlotMachineAudioProcessor::captureFrozenBlock(int numChannels, int numSamples) noexcept
+{
+    // Far below audibility; tile and hit splits shift between loops, so rounding differs slightly
+    constexpr float tolerance = kFrozenLoopTolerance;
+
+    for (int done = 0; done < numSamples;)
+    {
+        const int position = (int)(frozenSamplesCaptured % frozenLoopLength);
+        const int n = juce::jmin(numSamples - done, frozenLoopLength - position);
+        const bool recording = frozenSamplesCaptured < frozenLoopLength;
+
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            const float* src = frozenScratch.getReadPointer(ch, done);
+            float* loop = frozenLoop.getWritePointer(ch, position);
+
+            if (recording)
+            {
+                std::memcpy(loop, src, sizeof(float) * (size_t)n);
+                continue;
+            }
+
+            for (int i = 0; i < n; ++i)
+                if (std::abs(src[i] - loop[i]) > tolerance)
+                    return false;
+        }
+
+        frozenSamplesCaptured += n;
+        done += n;
+    }
+
+    if (frozenSamplesCaptured >= 2 * (juce::int64)frozenLoopLength)
+    {
+        freezeState = FreezeState::playing;
+        frozenLoopPosition = (int)(frozenSamplesCaptured % frozenLoopLength);
+    }
+
+    return true;
+}
+
+void SlotMachineAudioProcessor::playFrozenBlock(juce::AudioBuffer<float>& buffer, int numSamples) noexcept
+{
+    const int numChannels = juce::jmin(2, buffer.getNumChannels());
+
+    for (int done = 0; done < numSamples;)
+    {
+        const int n = juce::jmin(numSamples - done, frozenLoopLength - frozenLoopPosition);
+
+        for (int ch = 0; ch < numChannels; ++ch)
+            buffer.addFrom(ch, done, frozenLoop, ch, frozenLoopPosition, n);
+
+        done += n;
+        frozenLoopPosition = (frozenLoopPosition + n) % frozenLoopLength;
+    }
+}
+
+//==============================================================================
+// Render-ahead mode
+class SlotMachineAudioProcessor::RenderAheadThread : public juce::Thread
+{
+public:
+    explicit RenderAheadThread(SlotMachineAudioProcessor& p)
+        : juce::Thread("Slot render-ahead"), owner(p)
+    {
+    }
+
+    void run() override
+    {
+        while (!threadShouldExit())
+        {
+            {
+                // The engine runs here rather than in processBlock, so it is checked here too
+                const RealtimeSafety::ScopedAudioCallback engineCallback;
+
+                while (!threadShouldExit() && owner.renderAheadChunk())
+                {
+                }
+            }
+
+            // The callback signals after every drain; the timeout only guards against a missed wake
+            wake.wait(5);
+        }
+    }
+
+    // Safe from the audio thread: RealtimeWake never locks
+    void wakeUp() noexcept { wake.signal(); }
+
+private:
+    SlotMachineAudioProcessor& owner;
+    RealtimeWake wake;
+};
+
+void SlotMachineAudioProcessor::startRenderAhead(int samplesPerBlock)
+{
+    const bool wanted = renderAheadParam->load() >= 0.5f;
+
+    // Room for one host block plus two chunks: one being drained, one being rendered
+    const int blockInChunks = (juce::jmax(1, samplesPerBlock) + kRenderAheadChunk - 1) / kRenderAheadChunk;
+    renderAheadLatency = wanted ? (blockInChunks + 2) * kRenderAheadChunk : 0;
+    setLatencySamples(renderAheadLatency);
+
+    if (!wanted)
+        return;
+
+    const int numChannels = juce::jmax(1, getTotalNumOutputChannels());
+    renderAheadAudio.prepare(numChannels, renderAheadLatency);
+    renderAheadChunkBuffer.setSize(numChannels, kRenderAheadChunk, false, true, false);
+    renderAheadChunkMidi.ensureSize(4096);
+    renderAheadChunkMidi.clear();
+    renderAheadPassThrough.ensureSize(4096);
+    renderAheadInput.reset();
+    renderAheadMidiOut.reset();
+    numRenderAheadClicks = 0;
+    renderAheadReadPosition = 0;
+    renderAheadDebt = 0;
+
+    // Fill the lookahead before the first callback so playback does not open with an underrun
+    while (renderAheadChunk())
+    {
+    }
+
+    renderAheadActive = true;
+    renderAheadThread = std::make_unique<RenderAheadThread>(*this);
+
+    if (!renderAheadThread->startRealtimeThread(juce::Thread::RealtimeOptions{}.withPriority(8)))
+        renderAheadThread->startThread(juce::Thread::Priority::highest);
+}
+
+void SlotMachineAudioProcessor::stopRenderAhead()
+{
+    if (renderAheadThread != nullptr)
+    {
+        renderAheadThread->signalThreadShouldExit();
+        renderAheadThread->wakeUp();
+        renderAheadThread->stopThread(1000);
+        renderAheadThread.reset();
+    }
+
+    renderAheadActive = false;
+}
+
+// Render-ahead thread (or an offline callback): runs the engine for one chunk if the ring has
+// room for it. The ring never holds more than renderAheadLatency samples, so every event the
+// callback forwards (stamped renderAheadLatency samples after its own position) lands in a
+// chunk not yet rendered.
+bool SlotMachineAudioProcessor::renderAheadChunk()
+{
+    const juce::SpinLock::ScopedLockType engineLock(renderAheadEngineLock);
+
+    if (renderAheadAudio.getNumReady() + kRenderAheadChunk > renderAheadLatency)
+        return false;
+
+    juce::ScopedNoDenormals noDenormals;
+
+    const juce::int64 chunkStart = engineSampleClock;
+    const juce::int64 chunkEnd = chunkStart + kRenderAheadChunk;
+
+    renderAheadChunkMidi.clear();
+    numRenderAheadClicks = 0;
+
+    RenderAheadEvent event;
+    while (renderAheadInput.peek(event) && event.position < chunkEnd)
+    {
+        renderAheadInput.pop(event);
+        const int offset = (int)juce::jlimit<juce::int64>(0, kRenderAheadChunk - 1, event.position - chunkStart);
+
+        if (event.slot >= 0)
+        {
+            if (numRenderAheadClicks < (int)renderAheadClicks.size())
+                renderAheadClicks[(size_t)numRenderAheadClicks++] = { event.slot, offset };
+        }
+        else
+        {
+            renderAheadChunkMidi.addEvent(event.bytes, event.numBytes, offset);
+        }
+    }
+
+    renderAheadChunkBuffer.clear();
+    trace.record(AudioTrace::Type::engineChunkStart, -1, kRenderAheadChunk);
+    renderEngineBlock(renderAheadChunkBuffer, renderAheadChunkMidi, true);
+    trace.record(AudioTrace::Type::engineChunkEnd);
+
+    for (const auto metadata : renderAheadChunkMidi)
+    {
+        if (metadata.numBytes <= 0 || metadata.numBytes > 3)
+            continue;
+
+        RenderAheadEvent out;
+        out.position = chunkStart + metadata.samplePosition;
+        out.numBytes = metadata.numBytes;
+        std::memcpy(out.bytes, metadata.data, (size_t)metadata.numBytes);
+        renderAheadMidiOut.push(out);
+    }
+
+    renderAheadAudio.write(renderAheadChunkBuffer, kRenderAheadChunk);
+    return true;
+}
+
+// Host callback in render-ahead mode: forward this block's input to the engine, then play what
+// the render-ahead thread has already produced
+void SlotMachineAudioProcessor::drainRenderAhead(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midi)
+{
+    const int numSamples = buffer.getNumSamples();
+
+    for (int ch = getTotalNumInputChannels(); ch < getTotalNumOutputChannels(); ++ch)
+        buffer.clear(ch, 0, numSamples);
+
+    // Drop what an earlier underrun left us behind by, so the output stays on the host timeline
+    if (renderAheadDebt > 0)
+    {
+        const int dropped = renderAheadAudio.skip(juce::jmin(renderAheadDebt,
+            juce::jmax(0, renderAheadAudio.getNumReady() - numSamples)));
+        renderAheadDebt -= dropped;
+        renderAheadReadPosition += dropped;
+    }
+
+    // Input is delayed by exactly the reported latency. Long messages such as SysEx pass straight through.
+    const juce::int64 inputPosition = renderAheadReadPosition + renderAheadLatency;
+    renderAheadPassThrough.clear();
+
+    for (const auto metadata : midi)
+    {
+        if (metadata.numBytes > 3)
+        {
+            renderAheadPassThrough.addEvent(metadata.data, metadata.numBytes, metadata.samplePosition);
+            continue;
+        }
+
+        if (metadata.numBytes <= 0)
+            continue;
+
+        RenderAheadEvent event;
+        event.position = inputPosition + metadata.samplePosition;
+        event.numBytes = metadata.numBytes;
+        std::memcpy(event.bytes, metadata.data, (size_t)metadata.numBytes);
+        renderAheadInput.push(event);
+    }
+
+    popManualTriggers(numSamples, [this, inputPosition](int slot, int offset)
+    {
+        RenderAheadEvent event;
+        event.position = inputPosition + offset;
+        event.slot = slot;
+        renderAheadInput.push(event);
+    });
+
+    midi.swapWith(renderAheadPassThrough);
+
+    // An offline render may not underrun: it renders the missing chunks itself rather than wait
+    // on the thread, which may be stalled or gone. renderAheadChunk() stops once the ring is
+    // full, so this always ends. A realtime callback never takes the engine lock.
+    if (isNonRealtime())
+    {
+        const int wanted = juce::jmin(numSamples, renderAheadLatency);
+        while (renderAheadAudio.getNumReady() < wanted && renderAheadChunk())
         {
-            const float rightSample = (srcR != nullptr) ? srcR[i] : srcL[i];
-            dstR[i] += rightSample * currentEnv;
         }
+    }
 
-        env *= envAlpha;
-        ++envSamplesElapsed;
+    const int numRead = renderAheadAudio.addTo(buffer, 0, numSamples);
+
+    RenderAheadEvent event;
+    while (renderAheadMidiOut.peek(event) && event.position < renderAheadReadPosition + numRead)
+    {
+        renderAheadMidiOut.pop(event);
+        const int offset = (int)juce::jlimit<juce::int64>(0, juce::jmax(0, numSamples - 1), event.position - renderAheadReadPosition);
+        midi.addEvent(event.bytes, event.numBytes, offset);
     }
 
-    playIndex += toProcess;
+    renderAheadReadPosition += numRead;
+    renderAheadDebt += numSamples - numRead;
 
-    const bool finished = playIndex >= playLength
-        || (envMaxSamples > 0 && envSamplesElapsed >= envMaxSamples);
-    if (finished)
-        reset();
+    if (renderAheadThread != nullptr)
+        renderAheadThread->wakeUp();
 }
 
 void SlotMachineAudioProcessor::requestManualTrigger(int index)
@@ -2237,5 +3457,5 @@ void SlotMachineAudioProcessor::requestManualTrigger(int index)
     if (index < 0 || index >= kNumSlots)
         return;
 
-    pendingManualTriggers[(size_t)index].fetch_add(1, std::memory_order_relaxed);
+    manualTriggerQueue.push({ index, juce::Time::getHighResolutionTicks() });
 }
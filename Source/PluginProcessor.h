@@ -5,23 +5,59 @@
 #include <atomic>
 #include <cstdint>
 #include <limits>
-
+#include <vector>
+
+#include "AudioTrace.h"
+#include "AuditionEngine.h"
+#include "CpuLoadMeter.h"
+#include "DeferredRelease.h"
+#include "RealtimeAudioRing.h"
+#include "RealtimeFifo.h"
+#include "RealtimeSnapshot.h"
+#include "RenderWorkerPool.h"
+#include "SampleAnalysis.h"
+#include "SampleMemoryManager.h"
+#include "StoredSample.h"
+#include "ScheduledMidiEvents.h"
+#include "VoiceBank.h"
 #include "WaveformUtils.h"
 
-class SlotMachineAudioProcessor : public juce::AudioProcessor
+// Number of slots, fixed at build time. Add SLOTMACHINE_NUM_SLOTS=32 (or 64) to the exporter's
+// preprocessor definitions for a larger engine; parameters, state and editor all follow it.
+#ifndef SLOTMACHINE_NUM_SLOTS
+ #define SLOTMACHINE_NUM_SLOTS 16
+#endif
+
+class SlotMachineAudioProcessor : public juce::AudioProcessor,
+                                  private juce::AudioProcessorValueTreeState::Listener
 {
 public:
 
+    // Message thread only: queues a click on the slot, timestamped now
     void requestManualTrigger(int index);
 
     void clearSlot(int index, bool allowTail = false);
     void clearAllSlots();
 
     // ====== Constants ======
-    static constexpr int kNumSlots = 16;
+    static constexpr int kNumSlots = SLOTMACHINE_NUM_SLOTS;
+    static_assert(kNumSlots == 16 || kNumSlots == 32 || kNumSlots == 64, "Supported slot counts are 16, 32 and 64");
     static constexpr int kCountModeBaseBeats = 4;
     static constexpr int kScopeBlockSize = 256;
     static constexpr int kScopeBlocks    = 64;
+    static constexpr int kDefaultTriggerNoteBase = 36; // C1, first GM drum pad
+    static constexpr int kMaxExternalTriggersPerBlock = 256;
+    static constexpr int kManualTriggerQueueSize = 256;
+    static constexpr int kMaxScheduledMidiEvents = 1024;
+    static constexpr int kMaxHitsPerSlotPerBlock  = 128;
+    static constexpr int kMaxHitsPerBlock = 1024;
+    static constexpr int kSlotsPerRenderGroup = 4;  // slots rendered together as one task
+    static constexpr int kNumRenderGroups = kNumSlots / kSlotsPerRenderGroup;
+    static constexpr int kMinParallelRenderBlock = 128;
+    static constexpr int kMaxFrozenLoopSeconds = 10; // longest steady-state loop kept for playback
+    static constexpr float kFrozenLoopTolerance = 1.0e-4f; // how far a loop may differ from the captured one and still freeze
+    static constexpr int kRenderAheadChunk = 64;      // samples the render-ahead thread renders per pass
+    static constexpr int kRenderAheadQueueSize = 2048;
 
     // ====== Construction ======
     SlotMachineAudioProcessor();
@@ -100,19 +136,44 @@ public:
     void resetAllPhases(bool immediate);
     bool        slotHasSample(int index) const;
     juce::String getSlotFilePath(int index) const;
+    SampleAnalysis getSlotSampleAnalysis(int index) const;
+    SampleMemoryManager::Usage getSampleMemoryUsage();
     void        setSlotFilePath(int index, const juce::String& path);
     bool        loadSampleForSlot(int index, const juce::File& f, bool allowTail = false);
     bool        loadSampleForSlotFromMemory(int index, const void* data, int sizeBytes, const juce::String& pseudoName = {});
-    void        previewEmbeddedWav(const void* data, int sizeBytes);
+    void        previewEmbeddedWav(const juce::String& resourceName);
+    void        prefetchEmbeddedWavs(const juce::StringArray& resourceNames);
     void        upgradeLegacySlotParameters();
     juce::ValueTree copyStateWithVersion();
     void initialiseStateForFirstEditor();
     bool consumeInitialiseOnFirstEditor();
 
-    // UI polling
-    uint32_t getSlotHitCounter(int index) const;
-    double   getSlotPhase(int index) const;
-    double getMasterPhase() const;
+    // UI polling: the engine publishes one consistent copy of this per block
+    struct Telemetry
+    {
+        uint32_t blockIndex = 0;            // counts published blocks
+        double cyclePhase = 0.0;            // 0..1 over the full polyrhythmic cycle
+        double cycleBeats = 1.0;
+        int activeVoices = 0;               // voices and ringing tails across every slot
+        std::array<float, 2> outputPeak{};  // the block's peak magnitude per output channel
+        std::array<double, kNumSlots> slotPhases{};     // 0..1 over each slot's own period
+        std::array<uint32_t, kNumSlots> hitCounters{};  // bumps on every hit
+        std::array<uint8_t, kNumSlots> slotVoices{};    // 0..2: the slot's voice and its tail
+        std::array<float, kNumSlots> slotLevels{};      // envelope times gain of the slot's voice
+    };
+
+    // The engine's state as of its last block. Message thread only: the editor and the
+    // visualizer poll it from their timers.
+    Telemetry getTelemetry() noexcept { return telemetry.read(); }
+
+    // Audio-thread load over the last ~100 ms window, per stage and per slot. Call from
+    // one thread only (the editor and monitoring both poll from the message thread).
+    using CpuLoad = CpuLoadMeter<kNumSlots>::Load;
+    CpuLoad getCpuLoad() noexcept { return cpuLoadMeter.getLoad(); }
+
+    // Engine event recorder; off until enabled, exported on demand as a Chrome trace
+    AudioTrace& getTrace() noexcept { return trace; }
+
     bool exportAudioCycles(const juce::File& file, int cyclesToExport, juce::String& errorMessage);
 
     // Count beat masks
@@ -134,7 +195,58 @@ public:
     int    getBeatsPerBar() const noexcept { return numeratorAtomic.load(std::memory_order_relaxed); }
 
 private:
-    std::array<std::atomic<int>, kNumSlots> pendingManualTriggers;
+    void parameterChanged(const juce::String& parameterID, float newValue) override;
+
+    // Hit requested from outside the transport (MIDI note-on or UI click), resolved to a
+    // sample offset within the current block
+    struct ExternalTrigger
+    {
+        int slot = -1;
+        int offset = 0;
+        float velocity = 1.0f; // 0..1
+        bool fromClick = false;
+    };
+
+    // UI click as queued by requestManualTrigger()
+    struct ManualTriggerEvent
+    {
+        int slot = -1;
+        juce::int64 ticks = 0; // juce::Time high-resolution ticks
+    };
+
+    // One hit to fire on a slot during the current block
+    struct PendingHit
+    {
+        int offset = 0;
+        float velocityGain = 1.0f;
+    };
+
+    // A hit queued for the voice renderer, across all slots
+    struct BlockHit
+    {
+        int slot = -1;
+        int offset = 0;
+        float velocityGain = 1.0f;
+    };
+
+    // Short MIDI message or slot click on the engine's sample clock, passed between the host
+    // callback and the render-ahead thread
+    struct RenderAheadEvent
+    {
+        juce::int64 position = 0;
+        int slot = -1;             // >= 0 for a click, -1 for a MIDI message
+        juce::uint8 bytes[3] {};
+        int numBytes = 0;
+    };
+
+    // A click handed to the engine for the chunk being rendered ahead
+    struct RenderAheadClick
+    {
+        int slot = -1;
+        int offset = 0;
+    };
+
+    RealtimeEventFifo<ManualTriggerEvent, kManualTriggerQueueSize> manualTriggerQueue;
     std::array<std::atomic<uint64_t>, kNumSlots> countBeatMasks{};
     double currentCycleBeats = 1.0;
     double currentCyclePhase01 = 0.0;
@@ -144,13 +256,20 @@ private:
     {
         double framesPerPeriodCached = 0.0; // cached period in frames
 
-        juce::AudioBuffer<float> sample;     // mono duplicated to stereo
-        juce::AudioBuffer<float> tailSample; // retains previous sample while tail rings
+        StoredSample sample;                 // trimmed to its content, in the storage format chosen at load
+        StoredSample tailSample;             // retains previous sample while tail rings
+        bool tailReleasePending = false;     // the release queue was full: tailSample still holds its handle
+        ReleaseQueue<StoredSample, 256>* releaseQueue = nullptr;   // where the audio thread drops samples; null offline
+        AudioTrace* trace = nullptr;
+        int index = 0;
         double sampleRate = 44100.0;
         double phase = 0.0;   // 0..1 visual phase over its own period
         double framesUntilHit = 0.0;   // countdown to next trigger
+        double pendingClickBeat = -1.0; // quantised click waiting for its grid line (master beats)
+        int    hitsDueNextBlock = 0;    // scheduled hits that round onto the next block's first sample
         float  panL = 0.7071f;
         float  panR = 0.7071f;
+        float  hitGain = 1.0f; // per-hit velocity scaling
         bool   active = false; // has sample
         uint32_t hitCounter = 0;
 
@@ -167,12 +286,10 @@ private:
         int   tailEnvMaxSamples = 0;
         float tailPanL = 0.7071f;
         float tailPanR = 0.7071f;
+        float tailHitGain = 1.0f;
         bool  tailActive = false;
         bool  wasAudibleLastBlock = false;
 
-        // persistence
-        juce::String filePath;
-
         // === Decay envelope (NEW) ===
         float env = 0.0f;
         float envAlpha = 1.0f;
@@ -208,48 +325,229 @@ private:
 
         //--------------------------
 
-        void loadFile(const juce::File& f);
-        void loadFromMemory(const void* data, int sizeBytes, const juce::String& pseudoName);
-        void trigger();
+        void loadFile(const juce::File& f, SampleMemoryManager& memory, StoredSample::Format format);
+        void loadFromMemory(const void* data, int sizeBytes, const juce::String& pseudoName,
+            SampleMemoryManager& memory, StoredSample::Format format);
+        void trigger(float velocityGain = 1.0f);
         void mixInto(juce::AudioBuffer<float>& io, int numSamples, float gain);
         void stopImmediate() noexcept;
+        void releaseTail() noexcept;
+        bool retireSample(StoredSample& s) noexcept;
+        void retireTailSample() noexcept;
+        void replaceSample(StoredSample& incoming, bool allowTail, std::array<StoredSample, 2>& unreleased) noexcept;
 
         bool hasSample() const { return active && sample.getNumSamples() > 0; }
-        void setFilePath(const juce::String& s) { filePath = s; }
-        juce::String getFilePath() const { return filePath; }
-
-        void clear(bool allowTail) noexcept;
 
     };
 
-    struct PreviewVoice
+    juce::SharedResourcePointer<SampleMemoryManager> sampleMemory;   // one per host process, shared by every instance
+    ReleaseQueue<StoredSample, 256> sampleReleases;
+    std::array<SlotVoice, kNumSlots> slots;
+
+    // A slot's next sample on its way from the message thread to the engine, which swaps it in at
+    // the start of a block so no voice bank ever holds a pointer into a sample that has gone.
+    // The message thread claims the cell (free, or ready but not yet taken) and publishes it as
+    // ready; the engine takes it and leaves behind any handle the release queue had no room
+    // for, which the next claim drops on the message thread.
+    struct SampleHandoff
     {
-        void reset() noexcept;
-        void start(juce::AudioBuffer<float> newSample) noexcept;
-        void mixInto(juce::AudioBuffer<float>& buffer, int numSamples) noexcept;
+        static constexpr int kFree = 0, kClaimed = 1, kReady = 2, kTaking = 3;
 
-        juce::AudioBuffer<float> sample;
-        int playIndex = -1;
-        int playLength = 0;
-        float env = 0.0f;
-        float envAlpha = 1.0f;
-        int envSamplesElapsed = 0;
-        int envMaxSamples = 0;
+        std::atomic<int> state { kFree };
+        StoredSample sample;
+        bool allowTail = false;
+        std::array<StoredSample, 2> unreleased;
     };
+    std::array<SampleHandoff, kNumSlots> sampleHandoffs;
 
-    std::array<SlotVoice, kNumSlots> slots;
-    PreviewVoice previewVoice;
-    juce::SpinLock previewLock;
+    // The message thread's view of each slot, current as soon as a load returns
+    struct SlotSampleInfo
+    {
+        juce::String filePath;
+        SampleAnalysis analysis;
+        bool loaded = false;
+    };
+    std::array<SlotSampleInfo, kNumSlots> slotSampleInfo;
+
+    AuditionEngine audition{ [this](const AuditionEngine::Source& source, double rate, StoredSample& sample)
+        {
+            return loadAuditionSample(source, rate, sample);
+        } };
     double currentSampleRate = 44100.0;
-    juce::AudioBuffer<float> scratchMono;
+    juce::AudioBuffer<float> scratchMono{ 1, kScopeBlockSize };
+    juce::MidiBuffer midiScratch;
+    std::array<ExternalTrigger, kMaxExternalTriggersPerBlock> externalTriggers{};
+    std::array<PendingHit, kMaxHitsPerSlotPerBlock> slotHits{};
+    std::array<BlockHit, kMaxHitsPerBlock> blockHits{};
+    std::array<float, kNumSlots> slotMixGains{};
+    int numBlockHits = 0;
+
+    // One bank per render group; lane 2k is the group's k-th slot voice, 2k + 1 its tail
+    std::array<VoiceBank<kSlotsPerRenderGroup * 2>, kNumRenderGroups> voiceBanks;
+    static_assert(kNumRenderGroups <= RenderWorkerPool::kMaxTasks, "Too many render groups for one pool run");
+    std::array<bool, kNumSlots> slotLive{}; // has a sample or a ringing voice this block
+    std::array<int, kNumRenderGroups> liveGroups{};
+    int numLiveGroups = 0;
+
+    // Optional multi-core rendering: worker w > 0 renders into renderScratch[w]
+    RenderWorkerPool renderPool;
+    std::array<juce::AudioBuffer<float>, RenderWorkerPool::kMaxWorkers + 1> renderScratch;
+    std::array<bool, RenderWorkerPool::kMaxWorkers + 1> renderScratchUsed{};
+    float* renderTaskDstL = nullptr;
+    float* renderTaskDstR = nullptr;
+    int renderTaskNumSamples = 0;
+
+    // ====== CPU load metering ======
+    using LoadMeter = CpuLoadMeter<kNumSlots>;
+    LoadMeter cpuLoadMeter;
+    LoadMeter::BlockTimes engineTimes;  // stage times of the block the engine is rendering
+    std::array<juce::int64, kNumRenderGroups> groupRenderTicks{}; // each written by the thread rendering the group
+
+    AudioTrace trace;
+
+    // ====== UI telemetry (engine thread -> message thread) ======
+    void publishTelemetry(const juce::AudioBuffer<float>& buffer, int numSamples) noexcept;
+    RealtimeSnapshot<Telemetry> telemetry;
+    uint32_t telemetryBlockIndex = 0;
+
+    // ====== Frozen-cycle playback (audio thread) ======
+    // Once nothing that shapes the output has changed, the voices' output is periodic in the
+    // poly-cycle. One loop of it is captured from the live render, checked against the next
+    // loop, then played back while voice state keeps advancing without mixing. Any change to
+    // the pattern drops straight back to live rendering.
+    //
+    // Playback saves the voice mixing only: slot scheduling, hit handling and MIDI out still
+    // run, and every sounding voice is still advanced once per VoiceBank tile.
+    enum class FreezeState { live, capturing, playing };
+
+    juce::AudioBuffer<float> frozenLoop;    // captured voice output, sized for kMaxFrozenLoopSeconds
+    juce::AudioBuffer<float> frozenScratch; // this block's voice output while capturing
+    bool freezeAvailable = false;           // the option was on at prepare, so the buffers above exist
+    FreezeState freezeState = FreezeState::live;
+    int frozenLoopLength = 0;
+    int frozenLoopPosition = 0;             // read position while playing
+    juce::int64 frozenSamplesCaptured = 0;  // first loop is recorded, the second compared
+    uint64_t frozenPatternSignature = 0;
+    double frozenBlockEndBeats = -1.0;      // detects transport jumps between blocks
+    std::atomic<uint32_t> patternEditCounter { 0 }; // bumped by sample loads and pattern changes
+
+    // ====== Render-ahead mode ======
+    // A background thread runs the engine up to renderAheadLatency samples ahead of the host in
+    // kRenderAheadChunk pieces; the callback only forwards input events and drains the ring.
+    // Chosen in prepareToPlay and reported to the host as latency.
+    class RenderAheadThread;
+    std::unique_ptr<RenderAheadThread> renderAheadThread;
+    bool renderAheadActive = false;
+    int  renderAheadLatency = 0;
+    RealtimeAudioRing renderAheadAudio;
+    RealtimeEventFifo<RenderAheadEvent, kRenderAheadQueueSize> renderAheadInput;   // callback -> engine
+    RealtimeEventFifo<RenderAheadEvent, kRenderAheadQueueSize> renderAheadMidiOut; // engine -> callback
+    juce::AudioBuffer<float> renderAheadChunkBuffer;
+    juce::MidiBuffer renderAheadChunkMidi;
+    juce::MidiBuffer renderAheadPassThrough; // callback side; midiScratch belongs to the engine
+    std::array<RenderAheadClick, kMaxExternalTriggersPerBlock> renderAheadClicks{};
+    int numRenderAheadClicks = 0;
+    juce::int64 renderAheadReadPosition = 0; // engine clock of the next sample the callback reads
+    int renderAheadDebt = 0;                 // samples to drop after an underrun to realign
+    juce::SpinLock renderAheadEngineLock;    // lets an offline callback render a chunk itself
     AudioBlockQueue<kScopeBlockSize, kScopeBlocks> scopeQueue;
     std::atomic<double> bpmAtomic { 120.0 };
     std::atomic<int>    numeratorAtomic { kCountModeBaseBeats };
     //-------------------
     double masterBeatsAccum = 0.0; // total beats elapsed while running (not modulo)
+    juce::int64 lastBlockStartTicks = 0; // callback time of the previous block, for click timestamps
+    juce::int64 engineSampleClock = 0;   // samples rendered since prepareToPlay
+    int idleScopeSamplesPushed = 0;      // silence sent to the scope since the engine went idle
+    ScheduledMidiEvents<kMaxScheduledMidiEvents> scheduledMidi; // note-offs that may land in later blocks
+    bool flushScheduledMidi = false;    // set by prepareToPlay: emit everything pending at the next block's start
 
     bool initialiseOnFirstEditor = true;
 
+    // ====== Cached parameter handles ======
+    struct SlotParameters
+    {
+        std::atomic<float>* mute = nullptr;
+        std::atomic<float>* solo = nullptr;
+        std::atomic<float>* rate = nullptr;
+        std::atomic<float>* count = nullptr;
+        std::atomic<float>* gain = nullptr;
+        std::atomic<float>* pan = nullptr;
+        std::atomic<float>* decay = nullptr;
+        std::atomic<float>* midiChannel = nullptr;
+        std::atomic<float>* triggerNote = nullptr;
+    };
+
+    std::array<SlotParameters, kNumSlots> slotParams{};
+    std::atomic<float>* masterRunParam = nullptr;
+    std::atomic<float>* masterBpmParam = nullptr;
+    std::atomic<float>* timingModeParam = nullptr;
+    std::atomic<float>* clickQuantiseParam = nullptr;
+    std::atomic<float>* midiGateParam = nullptr;
+    std::atomic<float>* midiVelocityParam = nullptr;
+    std::atomic<float>* parallelRenderParam = nullptr;
+    std::atomic<float>* freezePatternsParam = nullptr;
+    std::atomic<float>* renderAheadParam = nullptr;
+    std::atomic<float>* sampleStorageParam = nullptr;
+    std::atomic<float>* sampleMemoryParam = nullptr;
+
+    // ====== Derived per-slot state (audio thread) ======
+    // Parameter listeners only raise these flags; processBlock recomputes the flagged values
+    // before use, so pan gains, decay coefficients and the poly-cycle length are not rebuilt
+    // every block.
+    enum DerivedStateFlags : uint32_t
+    {
+        kDirtyPan   = 1u << 0,
+        kDirtyDecay = 1u << 1,
+        kDirtyRate  = 1u << 2,
+        kDirtyAll   = kDirtyPan | kDirtyDecay | kDirtyRate
+    };
+
+    struct SlotDerivedState
+    {
+        int  rateNumerator = 1;    // slot rate as a reduced fraction (hits per beat)
+        int  rateDenominator = 1;
+        bool inCycle = false;      // contributed to the last poly-cycle computation
+    };
+
+    std::array<std::atomic<uint32_t>, kNumSlots> slotDirtyFlags{};
+    std::atomic<bool> cycleDirty { true };
+    std::array<SlotDerivedState, kNumSlots> slotDerived{};
+    int lastTimingMode = -1;
+    double cachedCycleBeats = 1.0;
+
+    void cacheParameterHandles();
+
+    // Copy slot playback state into / out of a group's voice bank around each block's render
+    void loadVoiceBank(int group) noexcept;
+    void storeVoiceBank(int group) noexcept;
+    void renderSlotGroup(int group, float* dstL, float* dstR, int numSamples) noexcept;
+    static void renderSlotGroupTask(void* context, int taskIndex, int workerIndex) noexcept;
+    void renderVoices(float* dstL, float* dstR, int numSamples) noexcept;
+    bool isAnyVoiceSounding() noexcept;
+    void flushNoteOffsLeftByPrepare(juce::MidiBuffer& midi) noexcept;
+
+    uint64_t computePatternSignature(int numOutputChannels) const noexcept;
+    int  findFrozenLoopLength(double cycleBeats, double secondsPerBeat) const noexcept;
+    bool captureFrozenBlock(int numChannels, int numSamples) noexcept;
+    void playFrozenBlock(juce::AudioBuffer<float>& buffer, int numSamples) noexcept;
+    void invalidateFrozenCycle() noexcept { patternEditCounter.fetch_add(1, std::memory_order_release); }
+    void publishSlotSample(int index, StoredSample sample, bool allowTail);
+    void takePendingSamples() noexcept;
+
+    // One engine step: everything processBlock does when not rendering ahead
+    void renderEngineBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midi, bool renderingAhead);
+    template <typename Fn> void popManualTriggers(int numSamples, Fn&& onTrigger);
+    void startRenderAhead(int samplesPerBlock);
+    void stopRenderAhead();
+    bool renderAheadChunk();
+    void drainRenderAhead(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midi);
+    void updateVoiceBankGains(int slotIndex) noexcept;
+    void startVoiceBankLane(int slotIndex) noexcept;
+    StoredSample::Format getSampleStorageFormat() const noexcept;
+    size_t getSampleMemoryBudgetBytes() const noexcept;
+    bool loadAuditionSample(const AuditionEngine::Source& source, double rate, StoredSample& sample);
+    void markAllDerivedStateDirty() noexcept;
+
     void refreshSlotCountMasksFromState();
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SlotMachineAudioProcessor)
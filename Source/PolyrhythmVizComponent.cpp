@@ -16,14 +16,15 @@ PolyrhythmVizComponent::PolyrhythmVizComponent(SlotMachineAudioProcessor& proc,
     setOpaque(true);
     startTimerHz(60);
 
-    lastPhase = processor.getMasterPhase();
+    const auto telemetry = processor.getTelemetry();
+    lastPhase = telemetry.cyclePhase;
     masterPhase = lastPhase;
 
     for (int i = 0; i < kNumSlots; ++i)
     {
         auto& slot = slotVisuals[(size_t)i];
         slot.colour = juce::Colour::fromHSV(std::fmod((float)i * 0.12f, 1.0f), 0.82f, 0.92f, 1.0f);
-        slot.lastHitCounter = processor.getSlotHitCounter(i);
+        slot.lastHitCounter = telemetry.hitCounters[(size_t)i];
     }
 }
 
@@ -90,7 +91,8 @@ void PolyrhythmVizComponent::resized()
 
 void PolyrhythmVizComponent::timerCallback()
 {
-    const double currentPhase = processor.getMasterPhase();
+    const auto telemetry = processor.getTelemetry();
+    const double currentPhase = telemetry.cyclePhase;
     const bool wrapped = (currentPhase + 0.02) < lastPhase;
     if (wrapped)
         wrapFlash = 1.0f;
@@ -179,7 +181,7 @@ void PolyrhythmVizComponent::timerCallback()
         slot.beadPhase = juce::jlimit(0.0, 1.0, masterPhase);
         slot.beadAngle = slot.beadPhase * juce::MathConstants<double>::twoPi - juce::MathConstants<double>::halfPi;
 
-        const uint32_t hits = processor.getSlotHitCounter(i);
+        const uint32_t hits = telemetry.hitCounters[(size_t)i];
         if (hits != slot.lastHitCounter)
         {
             slot.lastHitCounter = hits;
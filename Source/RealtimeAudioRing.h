@@ -0,0 +1,73 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+
+// Single-producer / single-consumer ring of multichannel audio. prepare() allocates
+// and must be called while neither side is running; write(), addTo() and skip()
+// never allocate or block.
+class RealtimeAudioRing
+{
+public:
+    void prepare (int numChannels, int capacitySamples)
+    {
+        // AbstractFifo keeps one slot free to tell full from empty
+        fifo.setTotalSize (capacitySamples + 1);
+        storage.setSize (juce::jmax (1, numChannels), capacitySamples + 1, false, true, false);
+        fifo.reset();
+    }
+
+    void reset() noexcept                  { fifo.reset(); }
+    int  getNumReady() const noexcept      { return fifo.getNumReady(); }
+    int  getFreeSpace() const noexcept     { return fifo.getFreeSpace(); }
+    int  getNumChannels() const noexcept   { return storage.getNumChannels(); }
+
+    // producer: appends numSamples from source; returns false (writing nothing) if they do not fit
+    bool write (const juce::AudioBuffer<float>& source, int numSamples) noexcept
+    {
+        if (numSamples > fifo.getFreeSpace())
+            return false;
+
+        int start1 = 0, size1 = 0, start2 = 0, size2 = 0;
+        fifo.prepareToWrite (numSamples, start1, size1, start2, size2);
+
+        const int channels = juce::jmin (storage.getNumChannels(), source.getNumChannels());
+        for (int ch = 0; ch < channels; ++ch)
+        {
+            if (size1 > 0) storage.copyFrom (ch, start1, source, ch, 0, size1);
+            if (size2 > 0) storage.copyFrom (ch, start2, source, ch, size1, size2);
+        }
+
+        fifo.finishedWrite (size1 + size2);
+        return true;
+    }
+
+    // consumer: adds up to numSamples into dest at destStart; returns how many were read
+    int addTo (juce::AudioBuffer<float>& dest, int destStart, int numSamples) noexcept
+    {
+        int start1 = 0, size1 = 0, start2 = 0, size2 = 0;
+        fifo.prepareToRead (numSamples, start1, size1, start2, size2);
+
+        const int channels = juce::jmin (storage.getNumChannels(), dest.getNumChannels());
+        for (int ch = 0; ch < channels; ++ch)
+        {
+            if (size1 > 0) dest.addFrom (ch, destStart, storage, ch, start1, size1);
+            if (size2 > 0) dest.addFrom (ch, destStart + size1, storage, ch, start2, size2);
+        }
+
+        fifo.finishedRead (size1 + size2);
+        return size1 + size2;
+    }
+
+    // consumer: discards up to numSamples; returns how many were dropped
+    int skip (int numSamples) noexcept
+    {
+        int start1 = 0, size1 = 0, start2 = 0, size2 = 0;
+        fifo.prepareToRead (numSamples, start1, size1, start2, size2);
+        fifo.finishedRead (size1 + size2);
+        return size1 + size2;
+    }
+
+private:
+    juce::AbstractFifo fifo { 1 };
+    juce::AudioBuffer<float> storage;
+};
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <array>
+#include <type_traits>
+
+// Fixed-capacity single-producer / single-consumer queue of small trivially
+// copyable events. Neither side allocates or blocks, so either end may live on
+// the audio thread. push() drops the event and returns false when full.
+template <typename EventType, int Capacity>
+class RealtimeEventFifo
+{
+public:
+    RealtimeEventFifo()
+        : fifo (Capacity)
+    {
+        static_assert(Capacity > 1, "Capacity must hold at least one event");
+        static_assert(std::is_trivially_copyable<EventType>::value, "Events are copied by value");
+    }
+
+    // producer
+    bool push (const EventType& event) noexcept
+    {
+        int start1 = 0, size1 = 0, start2 = 0, size2 = 0;
+        fifo.prepareToWrite (1, start1, size1, start2, size2);
+
+        if (size1 > 0)
+            events[(size_t) start1] = event;
+        else if (size2 > 0)
+            events[(size_t) start2] = event;
+        else
+            return false;
+
+        fifo.finishedWrite (size1 + size2);
+        return true;
+    }
+
+    // consumer: hands every queued event to fn in FIFO order, returns the count
+    template <typename Fn>
+    int popAll (Fn&& fn) noexcept
+    {
+        int start1 = 0, size1 = 0, start2 = 0, size2 = 0;
+        fifo.prepareToRead (fifo.getNumReady(), start1, size1, start2, size2);
+
+        for (int i = 0; i < size1; ++i)
+            fn (events[(size_t) (start1 + i)]);
+        for (int i = 0; i < size2; ++i)
+            fn (events[(size_t) (start2 + i)]);
+
+        fifo.finishedRead (size1 + size2);
+        return size1 + size2;
+    }
+
+    // consumer: pops a single event, returns false when empty
+    bool pop (EventType& out) noexcept
+    {
+        int start1 = 0, size1 = 0, start2 = 0, size2 = 0;
+        fifo.prepareToRead (1, start1, size1, start2, size2);
+
+        if (size1 > 0)
+            out = events[(size_t) start1];
+        else if (size2 > 0)
+            out = events[(size_t) start2];
+        else
+            return false;
+
+        fifo.finishedRead (size1 + size2);
+        return true;
+    }
+
+    // consumer: copies the oldest event without removing it, returns false when empty
+    bool peek (EventType& out) const noexcept
+    {
+        if (fifo.getNumReady() <= 0)
+            return false;
+
+        int start1 = 0, size1 = 0, start2 = 0, size2 = 0;
+        fifo.prepareToRead (1, start1, size1, start2, size2);
+        out = events[(size_t) (size1 > 0 ? start1 : start2)];
+        return true;
+    }
+
+    int  getNumReady() const noexcept   { return fifo.getNumReady(); }
+    void reset() noexcept               { fifo.reset(); }
+
+    constexpr static int getCapacity()  { return Capacity - 1; }
+
+private:
+    juce::AbstractFifo fifo;
+    std::array<EventType, (size_t) Capacity> events{};
+};
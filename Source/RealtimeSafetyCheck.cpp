@@ -0,0 +1,411 @@
+#include "RealtimeSafetyCheck.h"
+
+#if SLOTMACHINE_RT_CHECK
+
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <cstdlib>
+#include <new>
+
+#if __has_include(<execinfo.h>)
+#include <execinfo.h>
+#define SLOTMACHINE_RT_CHECK_BACKTRACE 1
+#else
+#define SLOTMACHINE_RT_CHECK_BACKTRACE 0
+#endif
+
+#if __has_include(<cxxabi.h>)
+#include <cxxabi.h>
+#endif
+
+#if defined(__GLIBC__)
+#include <dlfcn.h>
+#include <pthread.h>
+#include <semaphore.h>
+#define SLOTMACHINE_RT_CHECK_GLIBC 1
+
+// glibc's own allocator entry points, which the hooks below forward to
+extern "C"
+{
+    void* __libc_malloc(size_t);
+    void* __libc_calloc(size_t, size_t);
+    void* __libc_realloc(void*, size_t);
+    void* __libc_memalign(size_t, size_t);
+    void __libc_free(void*);
+}
+#else
+#define SLOTMACHINE_RT_CHECK_GLIBC 0
+#endif
+
+namespace
+{
+    // Plain thread_locals with constant initialisers, so reading them never allocates
+    thread_local int callbackDepth = 0;
+    thread_local int permitDepth = 0;
+    thread_local bool recording = false;
+
+    struct Slot
+    {
+        RealtimeSafety::Violation violation;
+        std::atomic<bool> complete{ false };
+    };
+
+    std::array<Slot, (size_t)RealtimeSafety::kMaxViolations> slots;
+    std::atomic<int> numViolations{ 0 };
+
+    void record(RealtimeSafety::ViolationKind kind, const char* function) noexcept
+    {
+        recording = true; // anything the stack capture allocates is ours, not the callback's
+
+        const int index = numViolations.fetch_add(1, std::memory_order_acq_rel);
+        if (index < RealtimeSafety::kMaxViolations)
+        {
+            auto& slot = slots[(size_t)index];
+            slot.violation.kind = kind;
+            slot.violation.function = function;
+#if SLOTMACHINE_RT_CHECK_BACKTRACE
+            slot.violation.numFrames = backtrace(slot.violation.frames, RealtimeSafety::kMaxStackFrames);
+#else
+            slot.violation.numFrames = 0;
+#endif
+            slot.complete.store(true, std::memory_order_release);
+        }
+
+        recording = false;
+    }
+
+    inline void check(RealtimeSafety::ViolationKind kind, const char* function) noexcept
+    {
+        if (callbackDepth > 0 && permitDepth == 0 && !recording)
+            record(kind, function);
+    }
+
+    // The first backtrace() loads the unwinder, which allocates; get that over with early
+    struct WarmUp
+    {
+        WarmUp()
+        {
+#if SLOTMACHINE_RT_CHECK_BACKTRACE
+            void* frames[2];
+            backtrace(frames, 2);
+#endif
+        }
+    } warmUp;
+
+    inline void* allocate(size_t size) noexcept
+    {
+#if SLOTMACHINE_RT_CHECK_GLIBC
+        return __libc_malloc(size == 0 ? 1 : size);
+#else
+        return std::malloc(size == 0 ? 1 : size);
+#endif
+    }
+
+    inline void deallocate(void* p) noexcept
+    {
+#if SLOTMACHINE_RT_CHECK_GLIBC
+        __libc_free(p);
+#else
+        std::free(p);
+#endif
+    }
+
+    const char* describeKind(RealtimeSafety::ViolationKind kind)
+    {
+        switch (kind)
+        {
+            case RealtimeSafety::ViolationKind::allocation:   return "allocation";
+            case RealtimeSafety::ViolationKind::deallocation: return "deallocation";
+            case RealtimeSafety::ViolationKind::blockingCall: return "blocking call";
+        }
+
+        return "";
+    }
+
+    // backtrace_symbols() gives "binary(mangled+offset) [address]"; demangle where we can
+    juce::String describeFrame(const char* symbol)
+    {
+        juce::String text(symbol);
+
+#if __has_include(<cxxabi.h>)
+        const int open = text.indexOfChar('(');
+        const int plus = text.indexOfChar(open, '+');
+        if (open >= 0 && plus > open + 1)
+        {
+            const auto mangled = text.substring(open + 1, plus);
+            int status = 0;
+            if (char* demangled = abi::__cxa_demangle(mangled.toRawUTF8(), nullptr, nullptr, &status))
+            {
+                if (status == 0)
+                    text = text.substring(0, open + 1) + demangled + text.substring(plus);
+                std::free(demangled);
+            }
+        }
+#endif
+
+        return text;
+    }
+}
+
+//==============================================================================
+namespace RealtimeSafety
+{
+    ScopedAudioCallback::ScopedAudioCallback() noexcept    { ++callbackDepth; }
+    ScopedAudioCallback::~ScopedAudioCallback() noexcept   { --callbackDepth; }
+
+    ScopedPermit::ScopedPermit() noexcept    { ++permitDepth; }
+    ScopedPermit::~ScopedPermit() noexcept   { --permitDepth; }
+
+    int getNumViolations() noexcept
+    {
+        return numViolations.load(std::memory_order_acquire);
+    }
+
+    Violation getViolation(int index) noexcept
+    {
+        if (index < 0 || index >= kMaxViolations || !slots[(size_t)index].complete.load(std::memory_order_acquire))
+            return {};
+
+        return slots[(size_t)index].violation;
+    }
+
+    void clearViolations() noexcept
+    {
+        for (auto& slot : slots)
+            slot.complete.store(false, std::memory_order_relaxed);
+
+        numViolations.store(0, std::memory_order_release);
+    }
+
+    juce::String describeViolations()
+    {
+        const ScopedPermit permit;
+
+        const int total = getNumViolations();
+        const int kept = juce::jmin(total, kMaxViolations);
+
+        juce::String report;
+        for (int i = 0; i < kept; ++i)
+        {
+            const auto v = getViolation(i);
+            report << "#" << (i + 1) << ": " << describeKind(v.kind) << " in " << v.function << juce::newLine;
+
+#if SLOTMACHINE_RT_CHECK_BACKTRACE
+            if (char** symbols = backtrace_symbols(v.frames, v.numFrames))
+            {
+                for (int f = 0; f < v.numFrames; ++f)
+                    report << "    " << describeFrame(symbols[f]) << juce::newLine;
+                std::free(symbols);
+            }
+#endif
+        }
+
+        if (total > kept)
+            report << "(" << (total - kept) << " more not kept)" << juce::newLine;
+
+        return report;
+    }
+}
+
+//==============================================================================
+// Replacements for the global allocation functions. The array, nothrow and sized forms
+// forward to these in the standard library; the aligned forms end up in aligned_alloc,
+// which is hooked below on glibc.
+void* operator new(size_t size)
+{
+    check(RealtimeSafety::ViolationKind::allocation, "operator new");
+    if (void* p = allocate(size))
+        return p;
+    throw std::bad_alloc();
+}
+
+void* operator new[](size_t size)
+{
+    check(RealtimeSafety::ViolationKind::allocation, "operator new[]");
+    if (void* p = allocate(size))
+        return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept
+{
+    if (p == nullptr)
+        return;
+    check(RealtimeSafety::ViolationKind::deallocation, "operator delete");
+    deallocate(p);
+}
+
+void operator delete[](void* p) noexcept
+{
+    if (p == nullptr)
+        return;
+    check(RealtimeSafety::ViolationKind::deallocation, "operator delete[]");
+    deallocate(p);
+}
+
+void operator delete(void* p, size_t) noexcept     { ::operator delete(p); }
+void operator delete[](void* p, size_t) noexcept   { ::operator delete[](p); }
+
+#if SLOTMACHINE_RT_CHECK_GLIBC
+//==============================================================================
+// The C allocator, which JUCE's HeapBlock (and so AudioBuffer and MemoryBlock) uses directly
+extern "C" void* malloc(size_t size) noexcept
+{
+    check(RealtimeSafety::ViolationKind::allocation, "malloc");
+    return __libc_malloc(size);
+}
+
+extern "C" void* calloc(size_t count, size_t size) noexcept
+{
+    check(RealtimeSafety::ViolationKind::allocation, "calloc");
+    return __libc_calloc(count, size);
+}
+
+extern "C" void* realloc(void* p, size_t size) noexcept
+{
+    check(RealtimeSafety::ViolationKind::allocation, "realloc");
+    return __libc_realloc(p, size);
+}
+
+extern "C" void free(void* p) noexcept
+{
+    if (p == nullptr)
+        return;
+    check(RealtimeSafety::ViolationKind::deallocation, "free");
+    __libc_free(p);
+}
+
+extern "C" void* memalign(size_t alignment, size_t size) noexcept
+{
+    check(RealtimeSafety::ViolationKind::allocation, "memalign");
+    return __libc_memalign(alignment, size);
+}
+
+extern "C" void* aligned_alloc(size_t alignment, size_t size) noexcept
+{
+    check(RealtimeSafety::ViolationKind::allocation, "aligned_alloc");
+    return __libc_memalign(alignment, size);
+}
+
+extern "C" int posix_memalign(void** result, size_t alignment, size_t size) noexcept
+{
+    check(RealtimeSafety::ViolationKind::allocation, "posix_memalign");
+
+    if (alignment < sizeof(void*) || (alignment & (alignment - 1)) != 0)
+        return EINVAL;
+
+    void* p = __libc_memalign(alignment, size);
+    if (p == nullptr)
+        return ENOMEM;
+
+    *result = p;
+    return 0;
+}
+
+//==============================================================================
+// Blocking pthread calls, forwarded to the next definition (libc's). trylock variants and
+// atomics-based locks such as juce::SpinLock are not blocking calls and are not hooked.
+namespace
+{
+    // On x86 glibc exports two pthread_cond_* versions and plain dlsym returns the old
+    // GLIBC_2.2.5 compat one, which must not see a modern pthread_cond_t; ask for the
+    // default version by name. Other targets have a single version.
+    void* lookUpNext(const char* name, const char* version) noexcept
+    {
+#if defined(__x86_64__) || defined(__i386__)
+        if (version != nullptr)
+            if (void* fn = dlvsym(RTLD_NEXT, name, version))
+                return fn;
+#else
+        juce::ignoreUnused(version);
+#endif
+        return dlsym(RTLD_NEXT, name);
+    }
+
+    // dlsym may allocate (its error buffer, for one), so every hook is resolved by Resolver
+    // below at static-init time, outside any callback. A call made earlier than that, by
+    // another static initialiser, resolves here on first use.
+    template <typename Fn>
+    Fn resolveNext(std::atomic<void*>& cache, const char* name, const char* version = nullptr) noexcept
+    {
+        void* fn = cache.load(std::memory_order_acquire);
+        if (fn == nullptr)
+        {
+            fn = lookUpNext(name, version);
+            cache.store(fn, std::memory_order_release);
+        }
+
+        return reinterpret_cast<Fn>(fn);
+    }
+
+    constexpr const char* kCondVersion = "GLIBC_2.3.2";
+
+    std::atomic<void*> realMutexLock{ nullptr };
+    std::atomic<void*> realRwlockRdlock{ nullptr };
+    std::atomic<void*> realRwlockWrlock{ nullptr };
+    std::atomic<void*> realCondWait{ nullptr };
+    std::atomic<void*> realCondTimedwait{ nullptr };
+    std::atomic<void*> realSemWait{ nullptr };
+    std::atomic<void*> realSemTimedwait{ nullptr };
+
+    struct Resolver
+    {
+        Resolver() noexcept
+        {
+            resolveNext<void*>(realMutexLock, "pthread_mutex_lock");
+            resolveNext<void*>(realRwlockRdlock, "pthread_rwlock_rdlock");
+            resolveNext<void*>(realRwlockWrlock, "pthread_rwlock_wrlock");
+            resolveNext<void*>(realCondWait, "pthread_cond_wait", kCondVersion);
+            resolveNext<void*>(realCondTimedwait, "pthread_cond_timedwait", kCondVersion);
+            resolveNext<void*>(realSemWait, "sem_wait");
+            resolveNext<void*>(realSemTimedwait, "sem_timedwait");
+        }
+    } resolver;
+}
+
+extern "C" int pthread_mutex_lock(pthread_mutex_t* mutex) noexcept
+{
+    check(RealtimeSafety::ViolationKind::blockingCall, "pthread_mutex_lock");
+    return resolveNext<int (*)(pthread_mutex_t*)>(realMutexLock, "pthread_mutex_lock")(mutex);
+}
+
+extern "C" int pthread_rwlock_rdlock(pthread_rwlock_t* lock) noexcept
+{
+    check(RealtimeSafety::ViolationKind::blockingCall, "pthread_rwlock_rdlock");
+    return resolveNext<int (*)(pthread_rwlock_t*)>(realRwlockRdlock, "pthread_rwlock_rdlock")(lock);
+}
+
+extern "C" int pthread_rwlock_wrlock(pthread_rwlock_t* lock) noexcept
+{
+    check(RealtimeSafety::ViolationKind::blockingCall, "pthread_rwlock_wrlock");
+    return resolveNext<int (*)(pthread_rwlock_t*)>(realRwlockWrlock, "pthread_rwlock_wrlock")(lock);
+}
+
+extern "C" int pthread_cond_wait(pthread_cond_t* cond, pthread_mutex_t* mutex)
+{
+    check(RealtimeSafety::ViolationKind::blockingCall, "pthread_cond_wait");
+    return resolveNext<int (*)(pthread_cond_t*, pthread_mutex_t*)>(realCondWait, "pthread_cond_wait", kCondVersion)(cond, mutex);
+}
+
+extern "C" int pthread_cond_timedwait(pthread_cond_t* cond, pthread_mutex_t* mutex, const struct timespec* until)
+{
+    check(RealtimeSafety::ViolationKind::blockingCall, "pthread_cond_timedwait");
+    return resolveNext<int (*)(pthread_cond_t*, pthread_mutex_t*, const struct timespec*)>(
+        realCondTimedwait, "pthread_cond_timedwait", kCondVersion)(cond, mutex, until);
+}
+
+extern "C" int sem_wait(sem_t* sem)
+{
+    check(RealtimeSafety::ViolationKind::blockingCall, "sem_wait");
+    return resolveNext<int (*)(sem_t*)>(realSemWait, "sem_wait")(sem);
+}
+
+extern "C" int sem_timedwait(sem_t* sem, const struct timespec* until)
+{
+    check(RealtimeSafety::ViolationKind::blockingCall, "sem_timedwait");
+    return resolveNext<int (*)(sem_t*, const struct timespec*)>(realSemTimedwait, "sem_timedwait")(sem, until);
+}
+#endif // SLOTMACHINE_RT_CHECK_GLIBC
+
+#endif // SLOTMACHINE_RT_CHECK
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+
+// Diagnostic build mode that catches the audio thread allocating, freeing or blocking.
+//
+// Build with SLOTMACHINE_RT_CHECK=1 (Tools/RealtimeSafetyDriver does) and the global
+// operator new/delete, the malloc family and the blocking pthread primitives are
+// replaced. While a thread is inside a ScopedAudioCallback, each call into them is
+// recorded together with a stack trace, to be read back once the callback has returned.
+// Without the flag ScopedAudioCallback is empty and nothing is replaced.
+//
+// The malloc and pthread hooks need glibc; elsewhere only operator new/delete are checked.
+#ifndef SLOTMACHINE_RT_CHECK
+ #define SLOTMACHINE_RT_CHECK 0
+#endif
+
+namespace RealtimeSafety
+{
+    static constexpr int kMaxViolations = 64;
+    static constexpr int kMaxStackFrames = 32;
+
+    enum class ViolationKind
+    {
+        allocation,
+        deallocation,
+        blockingCall
+    };
+
+    struct Violation
+    {
+        ViolationKind kind = ViolationKind::allocation;
+        const char* function = "";    // the hooked call, e.g. "operator new" or "pthread_mutex_lock"
+        int numFrames = 0;
+        void* frames[kMaxStackFrames] {};
+    };
+
+    // True when the hooks are compiled in
+    constexpr bool isEnabled() noexcept    { return SLOTMACHINE_RT_CHECK != 0; }
+
+   #if SLOTMACHINE_RT_CHECK
+    // Marks the current thread as running the audio callback for the scope's lifetime
+    class ScopedAudioCallback
+    {
+    public:
+        ScopedAudioCallback() noexcept;
+        ~ScopedAudioCallback() noexcept;
+
+        JUCE_DECLARE_NON_COPYABLE (ScopedAudioCallback)
+    };
+
+    // Lets a block that is known to be safe (or reported elsewhere) run unchecked
+    class ScopedPermit
+    {
+    public:
+        ScopedPermit() noexcept;
+        ~ScopedPermit() noexcept;
+
+        JUCE_DECLARE_NON_COPYABLE (ScopedPermit)
+    };
+
+    // Violations so far, including any beyond kMaxViolations that were counted but not kept
+    int getNumViolations() noexcept;
+
+    // Copies a kept violation; index must be below jmin (getNumViolations(), kMaxViolations)
+    Violation getViolation (int index) noexcept;
+
+    void clearViolations() noexcept;
+
+    // Kind, function and symbolised stack of every kept violation
+    juce::String describeViolations();
+   #else
+    struct ScopedAudioCallback  { ScopedAudioCallback() noexcept {} };
+    struct ScopedPermit         { ScopedPermit() noexcept {} };
+
+    inline int getNumViolations() noexcept              { return 0; }
+    inline Violation getViolation (int) noexcept        { return {}; }
+    inline void clearViolations() noexcept              {}
+    inline juce::String describeViolations()            { return {}; }
+   #endif
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+
+// Latest-value hand-off from one writer thread to one reader thread (a triple buffer).
+// The writer fills write() and calls publish(); read() returns the most recent published
+// value, which stays untouched until the reader's next read(). Neither side blocks or
+// allocates, and a slow reader skips values but never sees a half-written one.
+//
+// write() hands back whichever buffer the reader last released, so the writer must set
+// every field before each publish().
+template <typename T>
+class RealtimeSnapshot
+{
+public:
+    // writer
+    T& write() noexcept                 { return buffers[(size_t) back]; }
+
+    // writer: makes the buffer from write() the latest value
+    void publish() noexcept
+    {
+        back = middle.exchange (back | kFreshBit, std::memory_order_acq_rel) & kIndexMask;
+    }
+
+    // reader: the latest published value; the previous one again if nothing new arrived
+    const T& read() noexcept
+    {
+        if ((middle.load (std::memory_order_relaxed) & kFreshBit) != 0)
+            front = middle.exchange (front, std::memory_order_acq_rel) & kIndexMask;
+
+        return buffers[(size_t) front];
+    }
+
+private:
+    static constexpr int kIndexMask = 3;
+    static constexpr int kFreshBit = 4;
+
+    std::array<T, 3> buffers{};
+    int back = 0;                   // writer only
+    std::atomic<int> middle { 1 };  // buffer index, plus kFreshBit until the reader takes it
+    int front = 2;                  // reader only
+};
@@ -0,0 +1,107 @@
+#include "RealtimeWake.h"
+
+#if JUCE_LINUX || JUCE_ANDROID
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <ctime>
+#elif JUCE_MAC || JUCE_IOS
+#include <dispatch/dispatch.h>
+#elif JUCE_WINDOWS
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#endif
+
+namespace
+{
+#if JUCE_LINUX || JUCE_ANDROID
+    static_assert(sizeof(std::atomic<int>) == sizeof(int), "the futex word is the atomic itself");
+
+    int* futexWord(std::atomic<int>& state) noexcept
+    {
+        return reinterpret_cast<int*>(&state);
+    }
+#endif
+}
+
+RealtimeWake::RealtimeWake()
+{
+#if JUCE_MAC || JUCE_IOS
+    handle = dispatch_semaphore_create(0);
+#elif JUCE_WINDOWS
+    // A maximum count of one: a second signal before the wait is simply refused
+    handle = CreateSemaphoreW(nullptr, 0, 1, nullptr);
+#endif
+}
+
+RealtimeWake::~RealtimeWake()
+{
+#if JUCE_MAC || JUCE_IOS
+    if (handle != nullptr)
+        dispatch_release((dispatch_semaphore_t)handle);
+#elif JUCE_WINDOWS
+    if (handle != nullptr)
+        CloseHandle((HANDLE)handle);
+#endif
+}
+
+void RealtimeWake::signal() noexcept
+{
+    if (state.exchange(kSignalled, std::memory_order_acq_rel) != kSleeping)
+        return;
+
+#if JUCE_LINUX || JUCE_ANDROID
+    syscall(SYS_futex, futexWord(state), FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
+#elif JUCE_MAC || JUCE_IOS
+    dispatch_semaphore_signal((dispatch_semaphore_t)handle);
+#elif JUCE_WINDOWS
+    ReleaseSemaphore((HANDLE)handle, 1, nullptr);
+#endif
+}
+
+bool RealtimeWake::wait(int timeoutMs) noexcept
+{
+    int expected = kSignalled;
+    if (state.compare_exchange_strong(expected, kIdle, std::memory_order_acq_rel))
+        return true;
+
+    expected = kIdle;
+    if (!state.compare_exchange_strong(expected, kSleeping, std::memory_order_acq_rel))
+    {
+        // A signal landed in between
+        state.store(kIdle, std::memory_order_relaxed);
+        return true;
+    }
+
+#if JUCE_LINUX || JUCE_ANDROID
+    if (timeoutMs < 0)
+    {
+        // Returns at once if signal() already changed the word
+        while (state.load(std::memory_order_acquire) == kSleeping)
+            syscall(SYS_futex, futexWord(state), FUTEX_WAIT_PRIVATE, kSleeping, nullptr, nullptr, 0);
+    }
+    else
+    {
+        timespec timeout;
+        timeout.tv_sec = timeoutMs / 1000;
+        timeout.tv_nsec = (long)(timeoutMs % 1000) * 1000000L;
+        syscall(SYS_futex, futexWord(state), FUTEX_WAIT_PRIVATE, kSleeping, &timeout, nullptr, 0);
+    }
+#elif JUCE_MAC || JUCE_IOS
+    // A signal that came after an earlier wait timed out leaves a count behind, which only
+    // makes this wait return early
+    dispatch_semaphore_wait((dispatch_semaphore_t)handle,
+                            timeoutMs < 0 ? DISPATCH_TIME_FOREVER
+                                          : dispatch_time(DISPATCH_TIME_NOW, (int64_t)timeoutMs * (int64_t)NSEC_PER_MSEC));
+#elif JUCE_WINDOWS
+    WaitForSingleObject((HANDLE)handle, timeoutMs < 0 ? INFINITE : (DWORD)timeoutMs);
+#else
+    // No lock-free kernel wake here: poll the flag instead
+    for (int waited = 0; state.load(std::memory_order_acquire) == kSleeping && (timeoutMs < 0 || waited < timeoutMs); ++waited)
+        juce::Thread::sleep(1);
+#endif
+
+    return state.exchange(kIdle, std::memory_order_acq_rel) == kSignalled;
+}
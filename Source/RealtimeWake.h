@@ -0,0 +1,31 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <atomic>
+
+// Wakes one thread that the audio callback feeds. juce::WaitableEvent::signal() locks a mutex;
+// signal() here never does. It is one atomic exchange, plus a kernel wake (a futex on Linux, a
+// dispatch semaphore on Apple platforms, a semaphore on Windows) only if the thread is asleep.
+//
+// A signal made while nobody waits is kept for the next wait(). wait() can also return early,
+// so callers recheck their own condition.
+class RealtimeWake
+{
+public:
+    RealtimeWake();
+    ~RealtimeWake();
+
+    // Any thread, including the audio thread
+    void signal() noexcept;
+
+    // The one waiting thread: true once signalled, false after timeoutMs (-1 waits for ever)
+    bool wait (int timeoutMs) noexcept;
+
+private:
+    static constexpr int kIdle = 0, kSignalled = 1, kSleeping = -1;
+
+    std::atomic<int> state { kIdle };
+    void* handle = nullptr;     // the platform semaphore, where there is one
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (RealtimeWake)
+};
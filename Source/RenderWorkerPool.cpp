@@ -0,0 +1,160 @@
+#include "RenderWorkerPool.h"
+
+//==============================================================================
+class RenderWorkerPool::Worker : public juce::Thread
+{
+public:
+    Worker(RenderWorkerPool& p, int index)
+        : juce::Thread("Slot render " + juce::String(index)), pool(p), workerIndex(index)
+    {
+    }
+
+    void run() override
+    {
+        auto seen = pool.generation.load(std::memory_order_acquire);
+
+        while (!threadShouldExit())
+        {
+            // Stay awake for a moment after each run: at small buffer sizes the next one
+            // arrives before a sleeping thread would even be scheduled again
+            const auto spinUntil = juce::Time::getHighResolutionTicks() + spinTicks;
+            while (pool.generation.load(std::memory_order_acquire) == seen
+                   && juce::Time::getHighResolutionTicks() < spinUntil && !threadShouldExit())
+                juce::Thread::yield();
+
+            if (pool.generation.load(std::memory_order_acquire) == seen)
+            {
+                // Announce the sleep before the last look, so run() either sees it or we see run()
+                sleeping.store(true, std::memory_order_seq_cst);
+                if (pool.generation.load(std::memory_order_seq_cst) == seen && !threadShouldExit())
+                    wake.wait(-1);
+                sleeping.store(false, std::memory_order_relaxed);
+                continue;
+            }
+
+            seen = pool.generation.load(std::memory_order_acquire);
+
+            while (pool.tasksRemaining.load(std::memory_order_acquire) > 0)
+                if (!pool.runOneTask(workerIndex))
+                    juce::Thread::yield();
+        }
+    }
+
+    // Audio thread: only enters the kernel when the worker has gone to sleep
+    void wakeIfSleeping() noexcept
+    {
+        if (sleeping.load(std::memory_order_seq_cst))
+            wake.signal();
+    }
+
+    void wakeUp() noexcept { wake.signal(); }
+
+private:
+    RenderWorkerPool& pool;
+    const int workerIndex;
+    const juce::int64 spinTicks = juce::Time::secondsToHighResolutionTicks(kSpinSeconds);
+    std::atomic<bool> sleeping { false };
+    RealtimeWake wake;
+};
+
+//==============================================================================
+RenderWorkerPool::RenderWorkerPool() = default;
+
+RenderWorkerPool::~RenderWorkerPool()
+{
+    stop();
+}
+
+void RenderWorkerPool::start(int numWorkerThreads)
+{
+    numWorkerThreads = juce::jlimit(0, kMaxWorkers, numWorkerThreads);
+    if (numWorkerThreads == numWorkers)
+        return;
+
+    stop();
+
+    for (int i = 0; i < numWorkerThreads; ++i)
+    {
+        auto worker = std::make_unique<Worker>(*this, i + 1);
+
+        // Fall back to a normal high-priority thread where realtime scheduling is refused
+        if (!worker->startRealtimeThread(juce::Thread::RealtimeOptions{}.withPriority(8)))
+            worker->startThread(juce::Thread::Priority::highest);
+
+        workers[(size_t)i] = std::move(worker);
+    }
+
+    numWorkers = numWorkerThreads;
+}
+
+void RenderWorkerPool::stop()
+{
+    for (auto& worker : workers)
+        if (worker != nullptr)
+            worker->signalThreadShouldExit();
+
+    for (auto& worker : workers)
+    {
+        if (worker != nullptr)
+        {
+            worker->wakeUp();
+            worker->stopThread(1000);
+            worker.reset();
+        }
+    }
+
+    numWorkers = 0;
+}
+
+void RenderWorkerPool::run(int numTasks, TaskFunction fn, void* context) noexcept
+{
+    if (numTasks <= 0 || fn == nullptr)
+        return;
+
+    const int participants = numWorkers + 1;
+
+    taskFunction.store(fn, std::memory_order_relaxed);
+    taskContext.store(context, std::memory_order_relaxed);
+
+    // Counted before dealing: a worker still spinning from the last run may steal immediately
+    tasksRemaining.store(numTasks, std::memory_order_release);
+
+    // Deal tasks round-robin; anything a full deque refuses runs on the caller
+    for (int task = 0; task < numTasks; ++task)
+    {
+        if (!queues[(size_t)(task % participants)].push(task))
+        {
+            fn(context, task, 0);
+            tasksRemaining.fetch_sub(1, std::memory_order_acq_rel);
+        }
+    }
+
+    generation.fetch_add(1, std::memory_order_seq_cst);
+
+    for (int i = 0; i < numWorkers; ++i)
+        workers[(size_t)i]->wakeIfSleeping();
+
+    // Help until everything is claimed, then wait for tasks still running on workers
+    while (tasksRemaining.load(std::memory_order_acquire) > 0)
+        runOneTask(0);
+}
+
+bool RenderWorkerPool::runOneTask(int workerIndex) noexcept
+{
+    const int participants = numWorkers + 1;
+    int task = -1;
+    bool found = workerIndex == 0 ? queues[0].pop(task)
+                                  : queues[(size_t)workerIndex].steal(task);
+
+    for (int i = 1; !found && i < participants; ++i)
+        found = queues[(size_t)((workerIndex + i) % participants)].steal(task);
+
+    if (!found)
+        return false;
+
+    auto* fn = taskFunction.load(std::memory_order_relaxed);
+    fn(taskContext.load(std::memory_order_relaxed), task, workerIndex);
+
+    tasksRemaining.fetch_sub(1, std::memory_order_acq_rel);
+    return true;
+}
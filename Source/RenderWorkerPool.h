@@ -0,0 +1,126 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+#include "RealtimeWake.h"
+
+// Fixed-capacity Chase-Lev work-stealing deque of task indices. The owner pushes
+// and pops at the bottom, any thread may steal from the top. Indices only grow,
+// so a stale thief can never see a recycled slot as new. Never allocates.
+template <int Capacity>
+class WorkStealingDeque
+{
+public:
+    static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+    bool push (int task) noexcept
+    {
+        const auto b = bottom.load (std::memory_order_relaxed);
+        const auto t = top.load (std::memory_order_acquire);
+        if (b - t >= Capacity)
+            return false;
+
+        items[(size_t) (b & (Capacity - 1))].store (task, std::memory_order_relaxed);
+        std::atomic_thread_fence (std::memory_order_release);
+        bottom.store (b + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    bool pop (int& task) noexcept
+    {
+        const auto b = bottom.load (std::memory_order_relaxed) - 1;
+        bottom.store (b, std::memory_order_relaxed);
+        std::atomic_thread_fence (std::memory_order_seq_cst);
+        auto t = top.load (std::memory_order_relaxed);
+
+        if (t > b)
+        {
+            bottom.store (b + 1, std::memory_order_relaxed);
+            return false;
+        }
+
+        task = items[(size_t) (b & (Capacity - 1))].load (std::memory_order_relaxed);
+
+        if (t == b)
+        {
+            // Last item: race any thief for it
+            const bool won = top.compare_exchange_strong (t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+            bottom.store (b + 1, std::memory_order_relaxed);
+            return won;
+        }
+
+        return true;
+    }
+
+    bool steal (int& task) noexcept
+    {
+        auto t = top.load (std::memory_order_acquire);
+        std::atomic_thread_fence (std::memory_order_seq_cst);
+        const auto b = bottom.load (std::memory_order_acquire);
+
+        if (t >= b)
+            return false;
+
+        task = items[(size_t) (t & (Capacity - 1))].load (std::memory_order_relaxed);
+        return top.compare_exchange_strong (t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+    }
+
+private:
+    std::atomic<juce::int64> top { 0 };
+    std::atomic<juce::int64> bottom { 0 };
+    std::array<std::atomic<int>, (size_t) Capacity> items {};
+};
+
+// Fork-join pool for the audio callback. run() deals task indices into one deque
+// per participant; the caller owns every deque (it pushes, and pops its own share)
+// while workers steal, starting with the deque dealt to them. The call returns once
+// every task has finished. The caller always takes part as worker 0, so run() still
+// completes if the workers are slow to wake.
+//
+// Workers spin on a generation counter for kSpinSeconds after each run, then sleep on a
+// RealtimeWake; run() bumps the counter and signals only the workers that went to sleep.
+//
+// start()/stop() allocate and join threads: call them from prepareToPlay /
+// releaseResources, never from the audio thread. run() neither allocates nor locks.
+class RenderWorkerPool
+{
+public:
+    static constexpr int kMaxWorkers = 7;    // threads besides the caller
+    static constexpr int kMaxTasks = 64;     // per run(), per deque
+    static constexpr double kSpinSeconds = 0.002;
+
+    using TaskFunction = void (*) (void* context, int taskIndex, int workerIndex);
+
+    RenderWorkerPool();
+    ~RenderWorkerPool();
+
+    void start (int numWorkerThreads);
+    void stop();
+
+    int getNumWorkers() const noexcept { return numWorkers; }
+
+    // Audio thread: runs fn(context, task, worker) for task in [0, numTasks).
+    // worker is 0 for the calling thread and 1..getNumWorkers() for pool threads.
+    void run (int numTasks, TaskFunction fn, void* context) noexcept;
+
+private:
+    class Worker;
+    friend class Worker;
+
+    bool runOneTask (int workerIndex) noexcept;
+
+    std::array<WorkStealingDeque<kMaxTasks>, kMaxWorkers + 1> queues;
+    std::array<std::unique_ptr<Worker>, kMaxWorkers> workers;
+    int numWorkers = 0;
+
+    std::atomic<uint32_t> generation { 0 };  // bumped by every run()
+    std::atomic<int> tasksRemaining { 0 };
+    std::atomic<TaskFunction> taskFunction { nullptr };
+    std::atomic<void*> taskContext { nullptr };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (RenderWorkerPool)
+};
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <cmath>
+
+// Level and extent of a decoded sample, measured once when it is loaded.
+// Positions are in samples of the decoded (engine-rate) buffer before trimming.
+struct SampleAnalysis
+{
+    static constexpr float kOnsetLevelRelative = 0.001f;  // -60 dB below the peak
+    static constexpr float kContentEndLevel    = 1.0e-4f; // -80 dBFS, where voices retire
+
+    double sampleRate = 0.0;
+    int    sourceLength = 0;       // decoded length before trimming
+    int    onsetSample = 0;        // first sample at or above the onset level
+    int    contentEndSample = 0;   // one past the last sample at or above kContentEndLevel
+    float  peak = 0.0f;            // linear, across all channels
+    float  rms = 0.0f;             // linear, over the kept content
+    bool   silent = true;          // nothing reached kContentEndLevel; left untrimmed
+
+    int getContentLength() const noexcept   { return contentEndSample - onsetSample; }
+    int getLeadingTrim() const noexcept     { return onsetSample; }
+    int getTrailingTrim() const noexcept    { return sourceLength - contentEndSample; }
+
+    double samplesToMs (int numSamples) const noexcept
+    {
+        return sampleRate > 0.0 ? 1000.0 * (double) numSamples / sampleRate : 0.0;
+    }
+
+    static SampleAnalysis analyse (const juce::AudioBuffer<float>& buffer, double sampleRate)
+    {
+        SampleAnalysis result;
+        result.sampleRate = sampleRate;
+        result.sourceLength = buffer.getNumSamples();
+        result.contentEndSample = result.sourceLength;
+
+        const int numChannels = buffer.getNumChannels();
+        const int length = buffer.getNumSamples();
+        if (numChannels <= 0 || length <= 0)
+            return result;
+
+        for (int ch = 0; ch < numChannels; ++ch)
+            result.peak = juce::jmax (result.peak, buffer.getMagnitude (ch, 0, length));
+
+        if (! (result.peak >= kContentEndLevel))
+            return result;
+
+        result.silent = false;
+
+        // Onset is relative to the peak so a quiet noise floor ahead of the attack is
+        // dropped; the end is absolute so decays are kept for as long as they are audible
+        const float onsetLevel = juce::jmax (kContentEndLevel, result.peak * kOnsetLevelRelative);
+        result.onsetSample = findFirstAtOrAbove (buffer, onsetLevel);
+        result.contentEndSample = juce::jmax (result.onsetSample + 1, findLastAtOrAbove (buffer, kContentEndLevel) + 1);
+
+        double sumSquares = 0.0;
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            const float* data = buffer.getReadPointer (ch);
+            for (int i = result.onsetSample; i < result.contentEndSample; ++i)
+                sumSquares += (double) data[i] * (double) data[i];
+        }
+
+        result.rms = (float) std::sqrt (sumSquares / ((double) numChannels * (double) result.getContentLength()));
+        return result;
+    }
+
+    // Cuts buffer down to [onsetSample, contentEndSample), so the first sample a voice
+    // plays is the attack and no mix cycles go on trailing zeros. Silent buffers are kept.
+    static void trimToContent (juce::AudioBuffer<float>& buffer, const SampleAnalysis& analysis)
+    {
+        if (analysis.silent || buffer.getNumSamples() != analysis.sourceLength
+            || (analysis.onsetSample == 0 && analysis.contentEndSample == analysis.sourceLength))
+            return;
+
+        juce::AudioBuffer<float> trimmed (buffer.getNumChannels(), analysis.getContentLength());
+        for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+            trimmed.copyFrom (ch, 0, buffer, ch, analysis.onsetSample, analysis.getContentLength());
+
+        buffer = std::move (trimmed);
+    }
+
+private:
+    static int findFirstAtOrAbove (const juce::AudioBuffer<float>& buffer, float level) noexcept
+    {
+        int first = buffer.getNumSamples();
+        for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+        {
+            const float* data = buffer.getReadPointer (ch);
+            for (int i = 0; i < first; ++i)
+            {
+                if (std::abs (data[i]) >= level)
+                {
+                    first = i;
+                    break;
+                }
+            }
+        }
+
+        return first;
+    }
+
+    static int findLastAtOrAbove (const juce::AudioBuffer<float>& buffer, float level) noexcept
+    {
+        int last = -1;
+        for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+        {
+            const float* data = buffer.getReadPointer (ch);
+            for (int i = buffer.getNumSamples(); --i > last;)
+            {
+                if (std::abs (data[i]) >= level)
+                {
+                    last = i;
+                    break;
+                }
+            }
+        }
+
+        return last;
+    }
+};
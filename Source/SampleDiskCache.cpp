@@ -0,0 +1,172 @@
+#include "SampleDiskCache.h"
+
+#include <algorithm>
+
+namespace
+{
+    constexpr int kMagic = 0x43534d53; // "SMSC"
+    constexpr int kVersion = 1;
+    constexpr juce::int64 kDataAlignment = 64;
+
+    struct EntryHeader
+    {
+        juce::String key;
+        juce::int64 sourceStamp = 0;
+        StoredSample::Layout layout;
+        SampleAnalysis analysis;
+    };
+
+    void writeHeader(juce::OutputStream& out, const EntryHeader& header)
+    {
+        out.writeInt(kMagic);
+        out.writeInt(kVersion);
+        out.writeString(header.key);
+        out.writeInt64(header.sourceStamp);
+
+        out.writeInt(header.layout.numChannels);
+        out.writeInt(header.layout.numSamples);
+        out.writeInt((int)header.layout.format);
+        out.writeFloat(header.layout.scale);
+
+        out.writeDouble(header.analysis.sampleRate);
+        out.writeInt(header.analysis.sourceLength);
+        out.writeInt(header.analysis.onsetSample);
+        out.writeInt(header.analysis.contentEndSample);
+        out.writeFloat(header.analysis.peak);
+        out.writeFloat(header.analysis.rms);
+        out.writeBool(header.analysis.silent);
+
+        // Align the audio so mapped channels start on a cache line
+        const auto padding = (kDataAlignment - out.getPosition() % kDataAlignment) % kDataAlignment;
+        out.writeRepeatedByte(0, (size_t)padding);
+    }
+
+    // Returns the offset of the audio, or -1 if this is not an entry we can read
+    juce::int64 readHeader(juce::InputStream& in, EntryHeader& header)
+    {
+        if (in.readInt() != kMagic || in.readInt() != kVersion)
+            return -1;
+
+        header.key = in.readString();
+        header.sourceStamp = in.readInt64();
+
+        header.layout.numChannels = in.readInt();
+        header.layout.numSamples = in.readInt();
+        header.layout.format = (StoredSample::Format)in.readInt();
+        header.layout.scale = in.readFloat();
+
+        header.analysis.sampleRate = in.readDouble();
+        header.analysis.sourceLength = in.readInt();
+        header.analysis.onsetSample = in.readInt();
+        header.analysis.contentEndSample = in.readInt();
+        header.analysis.peak = in.readFloat();
+        header.analysis.rms = in.readFloat();
+        header.analysis.silent = in.readBool();
+
+        if (in.isExhausted() || !header.layout.isValid())
+            return -1;
+
+        const auto position = in.getPosition();
+        return position + (kDataAlignment - position % kDataAlignment) % kDataAlignment;
+    }
+}
+
+//==============================================================================
+SampleDiskCache::SampleDiskCache(const juce::File& dir, juce::int64 maxSize)
+    : directory(dir), maxBytes(maxSize)
+{
+}
+
+juce::File SampleDiskCache::getFileFor(const juce::String& key) const
+{
+    return directory.getChildFile(juce::String::toHexString(key.hashCode64()) + kExtension);
+}
+
+bool SampleDiskCache::load(const juce::String& key, juce::int64 sourceStamp, size_t maxResidentBytes,
+    StoredSample& sample, SampleAnalysis& analysis) const
+{
+    sample.reset();
+
+    const auto file = getFileFor(key);
+    juce::FileInputStream in(file);
+    if (!in.openedOk())
+        return false;
+
+    EntryHeader header;
+    const auto dataOffset = readHeader(in, header);
+
+    // The key is stored in full, so a hash collision reads as a miss
+    if (dataOffset < 0 || header.key != key || header.sourceStamp != sourceStamp
+        || in.getTotalLength() < dataOffset + (juce::int64)header.layout.getSizeInBytes())
+        return false;
+
+    bool loaded = false;
+    if (header.layout.getSizeInBytes() > maxResidentBytes)
+        loaded = sample.mapFile(file, dataOffset, header.layout, false);
+    else
+        loaded = in.setPosition(dataOffset) && sample.read(in, header.layout);
+
+    if (!loaded)
+        return false;
+
+    analysis = header.analysis;
+
+    // Modification time orders entries for trim(); the stamp that validates them is in the header
+    file.setLastModificationTime(juce::Time::getCurrentTime());
+    return true;
+}
+
+bool SampleDiskCache::save(const juce::String& key, juce::int64 sourceStamp, const juce::AudioBuffer<float>& decoded,
+    StoredSample::Format format, const SampleAnalysis& analysis)
+{
+    EntryHeader header;
+    header.key = key;
+    header.sourceStamp = sourceStamp;
+    header.layout = StoredSample::Layout::of(decoded, format);
+    header.analysis = analysis;
+
+    if (!header.layout.isValid() || !directory.createDirectory().wasOk())
+        return false;
+
+    juce::TemporaryFile temp(getFileFor(key));
+    {
+        juce::FileOutputStream out(temp.getFile());
+        if (out.failedToOpen())
+            return false;
+
+        writeHeader(out, header);
+        if (!StoredSample::writeEncoded(decoded, header.layout, out) || !out.getStatus().wasOk())
+            return false;
+    }
+
+    const bool saved = temp.overwriteTargetFileWithTemporary();
+    trim();
+    return saved;
+}
+
+void SampleDiskCache::trim() const
+{
+    auto files = directory.findChildFiles(juce::File::findFiles, false, juce::String("*") + kExtension);
+
+    juce::int64 total = 0;
+    for (const auto& f : files)
+        total += f.getSize();
+
+    if (total <= maxBytes)
+        return;
+
+    std::sort(files.begin(), files.end(), [](const juce::File& a, const juce::File& b)
+        {
+            return a.getLastModificationTime() < b.getLastModificationTime();
+        });
+
+    for (const auto& f : files)
+    {
+        if (total <= maxBytes)
+            break;
+
+        const auto size = f.getSize();
+        if (f.deleteFile())
+            total -= size;
+    }
+}
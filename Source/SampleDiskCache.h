@@ -0,0 +1,50 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include "SampleAnalysis.h"
+#include "StoredSample.h"
+
+// Decoded samples kept on disk between sessions, so reopening a session reads the
+// engine-rate audio back instead of decoding and resampling every file again.
+//
+// There is one file per source, sample rate and storage format, named after a hash of
+// that key: a fixed header (the key, the source's stamp, the stored layout and the
+// analysis) followed by the stored channels exactly as StoredSample keeps them, so an
+// entry can be mapped straight into a voice. An entry whose stamp no longer matches
+// its source (a file's modification time) is a miss and is overwritten by the next save.
+//
+// Entries are written to a temporary file and moved into place, so other instances
+// never see one half written. The least recently used entries are deleted once the
+// directory grows past its size limit.
+class SampleDiskCache
+{
+public:
+    static constexpr juce::int64 kDefaultMaxBytes = (juce::int64) 4 * 1024 * 1024 * 1024;
+
+    explicit SampleDiskCache (const juce::File& directory, juce::int64 maxBytes = kDefaultMaxBytes);
+
+    const juce::File& getDirectory() const noexcept   { return directory; }
+
+    // Fills sample and analysis from the entry for key if its stamp matches. A sample
+    // larger than maxResidentBytes stays in the file and is mapped; smaller ones are read
+    // onto the heap. Returns false, leaving sample empty, on a miss.
+    bool load (const juce::String& key, juce::int64 sourceStamp, size_t maxResidentBytes,
+               StoredSample& sample, SampleAnalysis& analysis) const;
+
+    // Writes the entry for key, replacing any older one, then trims the directory
+    bool save (const juce::String& key, juce::int64 sourceStamp, const juce::AudioBuffer<float>& decoded,
+               StoredSample::Format format, const SampleAnalysis& analysis);
+
+    // Deletes least recently used entries until the directory fits its size limit
+    void trim() const;
+
+private:
+    static constexpr const char* kExtension = ".smcache";
+
+    juce::File getFileFor (const juce::String& key) const;
+
+    juce::File directory;
+    juce::int64 maxBytes;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SampleDiskCache)
+};
@@ -0,0 +1,168 @@
+#include "SampleMemoryManager.h"
+
+#include <algorithm>
+#include <vector>
+
+//==============================================================================
+SampleMemoryManager::SampleMemoryManager()
+    : streamDirectory(juce::File::getSpecialLocation(juce::File::tempDirectory)
+        .getChildFile("SlotMachineStreams"))
+{
+}
+
+SampleMemoryManager::~SampleMemoryManager() = default;
+
+void SampleMemoryManager::setDiskCacheDirectory(const juce::File& directory)
+{
+    const juce::ScopedLock sl(lock);
+    if (diskCache == nullptr || diskCache->getDirectory() != directory)
+        diskCache = std::make_shared<SampleDiskCache>(directory);
+}
+
+juce::String SampleMemoryManager::makeKey(const juce::String& sourceId, double sampleRate, StoredSample::Format format)
+{
+    return sourceId + "|" + juce::String(juce::roundToInt(sampleRate)) + "|" + juce::String((int)format);
+}
+
+bool SampleMemoryManager::acquire(const juce::String& sourceId, juce::int64 sourceStamp, double sampleRate,
+    StoredSample::Format format, const DecodeFunction& decode, StoredSample& sample, SampleAnalysis& analysis)
+{
+    sample.reset();
+    analysis = {};
+
+    // The disk cache checks the stamp itself, so one entry per source is kept and replaced
+    const auto diskKey = makeKey(sourceId, sampleRate, format);
+    const auto key = diskKey + "@" + juce::String(sourceStamp);
+    std::shared_ptr<SampleDiskCache> disk;
+
+    {
+        const juce::ScopedLock sl(lock);
+        disk = diskCache;
+
+        auto it = entries.find(key);
+        if (it != entries.end())
+        {
+            it->second.lastUsed = ++useCounter;
+            sample = it->second.sample;
+            analysis = it->second.analysis;
+            return true;
+        }
+    }
+
+    // Load or decode outside the lock so other loads are not held up behind a long file
+    const size_t maxResidentBytes = getBudgetBytes() / 4;
+    StoredSample stored;
+    SampleAnalysis storedAnalysis;
+
+    if (disk == nullptr || !disk->load(diskKey, sourceStamp, maxResidentBytes, stored, storedAnalysis))
+    {
+        juce::AudioBuffer<float> decoded;
+        if (!decode || !decode(decoded, storedAnalysis) || decoded.getNumSamples() <= 0)
+            return false;
+
+        const auto layout = StoredSample::Layout::of(decoded, format);
+        const bool oversized = layout.getSizeInBytes() > maxResidentBytes;
+
+        // An oversized sample maps its new cache entry; without one it goes to a temporary file
+        if (disk != nullptr && disk->save(diskKey, sourceStamp, decoded, format, storedAnalysis) && oversized)
+            disk->load(diskKey, sourceStamp, maxResidentBytes, stored, storedAnalysis);
+
+        if (oversized && stored.getNumSamples() <= 0 && streamDirectory.createDirectory().wasOk())
+            stored.storeMapped(decoded, format, streamDirectory.getChildFile(juce::Uuid().toString() + ".raw"));
+
+        if (stored.getNumSamples() <= 0)
+            stored.store(decoded, format);
+    }
+
+    const juce::ScopedLock sl(lock);
+    auto& entry = entries[key];
+    if (entry.sample.getNumSamples() <= 0)
+    {
+        // Another caller may have decoded the same source meanwhile; keep whichever landed first
+        entry.sample = std::move(stored);
+        entry.analysis = storedAnalysis;
+    }
+
+    entry.lastUsed = ++useCounter;
+    sample = entry.sample;
+    analysis = entry.analysis;
+
+    trimLocked();
+    return true;
+}
+
+void SampleMemoryManager::trim()
+{
+    const juce::ScopedLock sl(lock);
+    trimLocked();
+}
+
+void SampleMemoryManager::trimLocked()
+{
+    const size_t budget = getBudgetBytes();
+    size_t resident = 0;
+    std::vector<std::pair<juce::uint64, juce::String>> unused;
+
+    for (auto it = entries.begin(); it != entries.end();)
+    {
+        const auto& sample = it->second.sample;
+        const bool inUse = sample.getNumHandles() > 1;
+
+        // Streamed samples cost no memory, but their mappings are only worth keeping while in use
+        if (sample.isMapped() && !inUse)
+        {
+            it = entries.erase(it);
+            continue;
+        }
+
+        if (!sample.isMapped())
+        {
+            resident += sample.getSizeInBytes();
+            if (!inUse)
+                unused.emplace_back(it->second.lastUsed, it->first);
+        }
+
+        ++it;
+    }
+
+    if (resident <= budget)
+        return;
+
+    std::sort(unused.begin(), unused.end());
+
+    for (const auto& candidate : unused)
+    {
+        if (resident <= budget)
+            break;
+
+        auto it = entries.find(candidate.second);
+        resident -= it->second.sample.getSizeInBytes();
+        entries.erase(it);
+    }
+}
+
+SampleMemoryManager::Usage SampleMemoryManager::getUsage() const
+{
+    const juce::ScopedLock sl(lock);
+
+    Usage usage;
+    usage.budgetBytes = getBudgetBytes();
+
+    for (const auto& [key, entry] : entries)
+    {
+        const size_t bytes = entry.sample.getSizeInBytes();
+        ++usage.numSamples;
+
+        if (entry.sample.isMapped())
+        {
+            usage.mappedBytes += bytes;
+            continue;
+        }
+
+        usage.residentBytes += bytes;
+        if (entry.sample.getNumHandles() > 1)
+            usage.inUseBytes += bytes;
+    }
+
+    return usage;
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include "SampleAnalysis.h"
+#include "SampleDiskCache.h"
+#include "StoredSample.h"
+
+#include <atomic>
+#include <functional>
+#include <map>
+#include <memory>
+
+// Owns every decoded sample the plugin holds. There is one per host process, shared by
+// every processor through a SharedResourcePointer, so twenty instances playing the same
+// kit hold each sample once. Slots, tails and offline renders take StoredSample handles
+// from acquire(); the manager keeps its own handle too, so a sample dropped by a pattern
+// change stays cached and reloads without decoding. Handles keep their audio alive on
+// their own, so instances can come and go in any order.
+//
+// Resident (heap) audio is held to a budget: trim() evicts the least recently used
+// samples that nothing but the cache is holding. A sample that would take more than a
+// quarter of the budget on its own is not made resident at all; it is written to a
+// temporary file and memory-mapped, so the OS streams it from disk as it plays.
+//
+// With a disk cache directory set, every decode is also saved there, and a sample that
+// is not in memory is looked for on disk before it is decoded. Oversized samples are
+// then mapped from their cache entry rather than from a temporary file.
+//
+// Thread-safe; call from the message thread or a loader thread, never from the audio thread.
+class SampleMemoryManager
+{
+public:
+    static constexpr size_t kDefaultBudgetBytes = (size_t) 1024 * 1024 * 1024;
+
+    // Decodes the source at the rate acquire() was asked for; false if it cannot be read
+    using DecodeFunction = std::function<bool (juce::AudioBuffer<float>& decoded, SampleAnalysis& analysis)>;
+
+    struct Usage
+    {
+        size_t budgetBytes = 0;
+        size_t residentBytes = 0;   // audio on the heap, in use or cached
+        size_t inUseBytes = 0;      // of which held by slots, tails or renders
+        size_t mappedBytes = 0;     // oversized samples streamed from disk
+        int    numSamples = 0;
+    };
+
+    SampleMemoryManager();
+    ~SampleMemoryManager();
+
+    // Lock-free; a smaller budget takes effect at the next acquire() or trim(). The budget is
+    // process-wide, so the instance that set it last wins.
+    void   setBudgetBytes (size_t newBudgetBytes) noexcept  { budgetBytes.store (newBudgetBytes, std::memory_order_relaxed); }
+    size_t getBudgetBytes() const noexcept                  { return budgetBytes.load (std::memory_order_relaxed); }
+
+    // Enables the on-disk cache; instances asking for the directory already in use keep it
+    void setDiskCacheDirectory (const juce::File& directory);
+
+    // Hands back the sample for sourceId at sampleRate in format, calling decode only if it is
+    // neither in memory nor on disk. sourceStamp must change whenever the source's content
+    // can have (a file's modification time; 0 if sourceId already identifies the content).
+    // Returns false, leaving sample empty, if decode fails.
+    bool acquire (const juce::String& sourceId, juce::int64 sourceStamp, double sampleRate, StoredSample::Format format,
+                  const DecodeFunction& decode, StoredSample& sample, SampleAnalysis& analysis);
+
+    // Evicts unused samples, least recently used first, until resident audio fits the budget
+    void trim();
+
+    Usage getUsage() const;
+
+private:
+    struct Entry
+    {
+        StoredSample sample;
+        SampleAnalysis analysis;
+        juce::uint64 lastUsed = 0;
+    };
+
+    static juce::String makeKey (const juce::String& sourceId, double sampleRate, StoredSample::Format format);
+    void trimLocked();
+
+    juce::File streamDirectory;
+    std::shared_ptr<SampleDiskCache> diskCache;
+    mutable juce::CriticalSection lock;
+    std::map<juce::String, Entry> entries;
+    std::atomic<size_t> budgetBytes { kDefaultBudgetBytes };
+    juce::uint64 useCounter = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SampleMemoryManager)
+};
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <array>
+#include <cstring>
+
+// Audio-thread-only store of short MIDI messages pinned to absolute sample
+// positions on the engine's running sample clock. Events that fall beyond the
+// current block stay queued and are emitted at their exact offset in a later
+// block, so their timing does not depend on the host buffer size.
+// Fixed capacity, never allocates; order within the store is unspecified.
+template <int Capacity>
+class ScheduledMidiEvents
+{
+public:
+    struct Event
+    {
+        juce::int64 samplePosition = 0;
+        juce::uint8 bytes[3] {};
+        int numBytes = 0;
+    };
+
+    // Queues a message of up to three bytes. Returns false when the store is full.
+    bool schedule (juce::int64 samplePosition, const juce::MidiMessage& message) noexcept
+    {
+        const int size = message.getRawDataSize();
+        if (numEvents >= Capacity || size <= 0 || size > 3)
+            return false;
+
+        auto& e = events[(size_t) numEvents++];
+        e.samplePosition = samplePosition;
+        e.numBytes = size;
+        std::memcpy (e.bytes, message.getRawData(), (size_t) size);
+        return true;
+    }
+
+    // Removes pending note-offs for channel/note due at or after fromSample.
+    // Returns true if any were queued, i.e. the note is still sounding at fromSample.
+    bool cancelNoteOff (int channel, int noteNumber, juce::int64 fromSample) noexcept
+    {
+        bool found = false;
+
+        for (int i = numEvents; --i >= 0;)
+        {
+            const auto& e = events[(size_t) i];
+            if (isNoteOff (e) && e.samplePosition >= fromSample
+                && (e.bytes[0] & 0x0f) + 1 == channel && e.bytes[1] == noteNumber)
+            {
+                removeAt (i);
+                found = true;
+            }
+        }
+
+        return found;
+    }
+
+    // Moves every event due inside [blockStart, blockStart + numSamples) into midi at its offset.
+    void renderBlock (juce::MidiBuffer& midi, juce::int64 blockStart, int numSamples) noexcept
+    {
+        const juce::int64 blockEnd = blockStart + numSamples;
+
+        for (int i = numEvents; --i >= 0;)
+        {
+            const auto& e = events[(size_t) i];
+            if (e.samplePosition >= blockEnd)
+                continue;
+
+            const int offset = (int) juce::jlimit<juce::int64> (0, juce::jmax (0, numSamples - 1), e.samplePosition - blockStart);
+            midi.addEvent (e.bytes, e.numBytes, offset);
+            removeAt (i);
+        }
+    }
+
+    // Emits everything still pending at one offset, e.g. so no note is left hanging.
+    void flushAll (juce::MidiBuffer& midi, int offset) noexcept
+    {
+        for (int i = 0; i < numEvents; ++i)
+            midi.addEvent (events[(size_t) i].bytes, events[(size_t) i].numBytes, offset);
+
+        numEvents = 0;
+    }
+
+    void clear() noexcept               { numEvents = 0; }
+    int  getNumPending() const noexcept { return numEvents; }
+
+    constexpr static int getCapacity()  { return Capacity; }
+
+private:
+    static bool isNoteOff (const Event& e) noexcept
+    {
+        const auto status = e.bytes[0] & 0xf0;
+        return status == 0x80 || (status == 0x90 && e.numBytes >= 3 && e.bytes[2] == 0);
+    }
+
+    void removeAt (int index) noexcept
+    {
+        events[(size_t) index] = events[(size_t) (numEvents - 1)];
+        --numEvents;
+    }
+
+    std::array<Event, (size_t) Capacity> events{};
+    int numEvents = 0;
+};
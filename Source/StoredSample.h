@@ -0,0 +1,291 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include "MixKernels.h"
+
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <memory>
+#include <utility>
+
+// A decoded sample as the voices read it: 32-bit float, or 16-bit integer / half float
+// for a half-size footprint. Channels that are exact copies of each other (mono files
+// decode to dual mono) are stored once.
+//
+// StoredSample is a handle: the encoded audio is immutable and shared by every copy,
+// so a slot, its ringing tail and the sample cache can all hold the same data. The
+// audio lives either on the heap or in a file mapped into memory (for samples too big
+// to keep resident, which the OS then pages in as they play). store() and reset() may
+// allocate or free, so call them off the audio thread; reads never allocate.
+class StoredSample
+{
+public:
+    using Format = MixKernels::SourceFormat;
+
+    // Shape of the stored audio: what a file written by writeEncoded() holds
+    struct Layout
+    {
+        int numChannels = 0;
+        int numSamples = 0;
+        float scale = 1.0f;
+        Format format = Format::float32;
+
+        size_t getBytesPerSample() const noexcept            { return format == Format::float32 ? sizeof (float) : sizeof (int16_t); }
+        size_t getChannelOffset (int channel) const noexcept { return (size_t) channel * (size_t) numSamples * getBytesPerSample(); }
+        size_t getSizeInBytes() const noexcept               { return getChannelOffset (numChannels); }
+
+        bool isValid() const noexcept
+        {
+            return (numChannels == 1 || numChannels == 2) && numSamples > 0 && std::isfinite (scale) && scale > 0.0f
+                && (format == Format::float32 || format == Format::int16 || format == Format::float16);
+        }
+
+        static Layout of (const juce::AudioBuffer<float>& source, Format format)
+        {
+            Layout layout;
+            layout.format = format;
+            layout.numSamples = source.getNumSamples();
+            layout.numChannels = juce::jmin (2, source.getNumChannels());
+
+            if (layout.numSamples <= 0 || layout.numChannels <= 0)
+                return {};
+
+            if (layout.numChannels == 2 && std::memcmp (source.getReadPointer (0), source.getReadPointer (1),
+                                                        sizeof (float) * (size_t) layout.numSamples) == 0)
+                layout.numChannels = 1;
+
+            float peak = 0.0f;
+            for (int ch = 0; ch < layout.numChannels; ++ch)
+                peak = juce::jmax (peak, source.getMagnitude (ch, 0, layout.numSamples));
+
+            // int16 spans the sample's own peak rather than full scale, so quiet material keeps its resolution
+            layout.scale = (format == Format::int16 && peak > 0.0f) ? peak / 32767.0f : 1.0f;
+            return layout;
+        }
+    };
+
+    StoredSample() = default;
+    StoredSample (const StoredSample&) = default;
+    StoredSample& operator= (const StoredSample&) = default;
+
+    StoredSample (StoredSample&& other) noexcept
+    {
+        *this = std::move (other);
+    }
+
+    // Leaves other empty
+    StoredSample& operator= (StoredSample&& other) noexcept
+    {
+        storage = std::move (other.storage);
+        channels = std::exchange (other.channels, {});
+        numChannels = std::exchange (other.numChannels, 0);
+        numSamples = std::exchange (other.numSamples, 0);
+        scale = std::exchange (other.scale, 1.0f);
+        format = std::exchange (other.format, Format::float32);
+        return *this;
+    }
+
+    // Encodes source on the heap
+    void store (const juce::AudioBuffer<float>& source, Format newFormat)
+    {
+        reset();
+
+        const auto layout = Layout::of (source, newFormat);
+        if (layout.numSamples <= 0)
+            return;
+
+        auto newStorage = std::make_shared<Storage>();
+        newStorage->heap.allocate (layout.getSizeInBytes(), false);
+
+        for (int ch = 0; ch < layout.numChannels; ++ch)
+            encode (source.getReadPointer (ch), layout.numSamples, newFormat, layout.scale,
+                    newStorage->heap.get() + layout.getChannelOffset (ch));
+
+        const char* base = newStorage->heap.get();
+        adopt (std::move (newStorage), base, layout);
+    }
+
+    // Encodes source into streamFile (replacing it) and maps the file, which is deleted once
+    // no handle uses it. Returns false, leaving the handle empty, if it cannot be written or mapped.
+    bool storeMapped (const juce::AudioBuffer<float>& source, Format newFormat, const juce::File& streamFile)
+    {
+        reset();
+
+        const auto layout = Layout::of (source, newFormat);
+        if (layout.numSamples <= 0)
+            return false;
+
+        bool written = false;
+        streamFile.deleteFile();
+        {
+            juce::FileOutputStream out (streamFile);
+            written = ! out.failedToOpen() && writeEncoded (source, layout, out);
+        }
+
+        if (! written)
+        {
+            streamFile.deleteFile();
+            return false;
+        }
+
+        return mapFile (streamFile, 0, layout, true);
+    }
+
+    // Maps audio that writeEncoded() put in file at dataOffset. Returns false, leaving the
+    // handle empty, if the file cannot be mapped or is too short for layout.
+    bool mapFile (const juce::File& file, juce::int64 dataOffset, const Layout& layout, bool deleteWhenReleased)
+    {
+        reset();
+
+        auto newStorage = std::make_shared<Storage>();
+        if (deleteWhenReleased)
+            newStorage->mappedFile = file;
+
+        newStorage->mapped = std::make_unique<juce::MemoryMappedFile> (file, juce::MemoryMappedFile::readOnly, false);
+
+        if (! layout.isValid() || dataOffset < 0 || newStorage->mapped->getData() == nullptr
+            || newStorage->mapped->getSize() < (size_t) dataOffset + layout.getSizeInBytes())
+            return false;
+
+        const auto* base = static_cast<const char*> (newStorage->mapped->getData()) + dataOffset;
+        adopt (std::move (newStorage), base, layout);
+        return true;
+    }
+
+    // Reads audio that writeEncoded() wrote onto the heap. Returns false, leaving the handle
+    // empty, if the stream runs out first.
+    bool read (juce::InputStream& in, const Layout& layout)
+    {
+        reset();
+
+        if (! layout.isValid())
+            return false;
+
+        auto newStorage = std::make_shared<Storage>();
+        newStorage->heap.allocate (layout.getSizeInBytes(), false);
+
+        // InputStream::read() takes an int count, so go in chunks
+        constexpr size_t kChunk = (size_t) 1 << 24;
+        for (size_t done = 0; done < layout.getSizeInBytes();)
+        {
+            const int n = (int) juce::jmin (kChunk, layout.getSizeInBytes() - done);
+            if (in.read (newStorage->heap.get() + done, n) != n)
+                return false;
+
+            done += (size_t) n;
+        }
+
+        const char* base = newStorage->heap.get();
+        adopt (std::move (newStorage), base, layout);
+        return true;
+    }
+
+    // Writes source in layout's format, channels back to back, as mapFile() and read() expect
+    static bool writeEncoded (const juce::AudioBuffer<float>& source, const Layout& layout, juce::OutputStream& out)
+    {
+        constexpr int kChunk = 1 << 16;
+        juce::HeapBlock<char> chunk ((size_t) kChunk * sizeof (float));
+
+        for (int ch = 0; ch < layout.numChannels; ++ch)
+        {
+            for (int start = 0; start < layout.numSamples; start += kChunk)
+            {
+                const int n = juce::jmin (kChunk, layout.numSamples - start);
+                encode (source.getReadPointer (ch, start), n, layout.format, layout.scale, chunk.get());
+                if (! out.write (chunk.get(), (size_t) n * layout.getBytesPerSample()))
+                    return false;
+            }
+        }
+
+        out.flush();
+        return true;
+    }
+
+    void reset() noexcept
+    {
+        *this = StoredSample();
+    }
+
+    int    getNumChannels() const noexcept  { return numChannels; }
+    int    getNumSamples() const noexcept   { return numSamples; }
+    Format getFormat() const noexcept       { return format; }
+    float  getScale() const noexcept        { return scale; }   // multiplies every stored value on read
+    bool   isMapped() const noexcept        { return storage != nullptr && storage->mapped != nullptr; }
+
+    size_t getBytesPerSample() const noexcept { return getLayout().getBytesPerSample(); }
+    size_t getSizeInBytes() const noexcept    { return getLayout().getSizeInBytes(); }
+
+    Layout getLayout() const noexcept         { return { numChannels, numSamples, scale, format }; }
+
+    // Start of a stored channel, or null if it is not stored (a mono sample has no channel 1)
+    const void* getChannel (int channel) const noexcept
+    {
+        return juce::isPositiveAndBelow (channel, numChannels) ? channels[(size_t) channel] : nullptr;
+    }
+
+    // Number of handles sharing this audio (0 when empty)
+    long getNumHandles() const noexcept      { return storage.use_count(); }
+
+private:
+    struct Storage
+    {
+        ~Storage()
+        {
+            mapped.reset();
+            if (mappedFile != juce::File())
+                mappedFile.deleteFile();
+        }
+
+        juce::HeapBlock<char> heap;
+        std::unique_ptr<juce::MemoryMappedFile> mapped;
+        juce::File mappedFile;   // deleted with the storage, if set
+    };
+
+    static void encode (const float* src, int n, Format format, float scale, void* dst) noexcept
+    {
+        switch (format)
+        {
+            case Format::int16:
+            {
+                auto* out = static_cast<int16_t*> (dst);
+                const float toInt = 1.0f / scale;
+                for (int i = 0; i < n; ++i)
+                    out[i] = (int16_t) juce::jlimit (-32767, 32767, (int) std::lround (src[i] * toInt));
+                break;
+            }
+
+            case Format::float16:
+            {
+                auto* out = static_cast<MixKernels::Float16*> (dst);
+                for (int i = 0; i < n; ++i)
+                    out[i] = MixKernels::Half::fromFloat (src[i]);
+                break;
+            }
+
+            case Format::float32:
+            default:
+                std::memcpy (dst, src, sizeof (float) * (size_t) n);
+                break;
+        }
+    }
+
+    void adopt (std::shared_ptr<const Storage> newStorage, const char* base, const Layout& layout) noexcept
+    {
+        for (int ch = 0; ch < layout.numChannels; ++ch)
+            channels[(size_t) ch] = base + layout.getChannelOffset (ch);
+
+        storage = std::move (newStorage);
+        numChannels = layout.numChannels;
+        numSamples = layout.numSamples;
+        scale = layout.scale;
+        format = layout.format;
+    }
+
+    std::shared_ptr<const Storage> storage;
+    std::array<const void*, 2> channels {};
+    int numChannels = 0;
+    int numSamples = 0;
+    float scale = 1.0f;
+    Format format = Format::float32;
+};
@@ -0,0 +1,187 @@
+#pragma once
+
+#include "MixKernels.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+// Structure-of-arrays playback state for every voice the engine can sound at
+// once. Only the fields touched per sample live here (read position, envelope,
+// gains), packed per field so a pass over the active voices streams through a
+// few contiguous arrays instead of hopping between SlotVoice objects.
+//
+// render() walks the output in small tiles and mixes every active voice into a
+// tile before moving on, so the destination stays in L1 however many voices are
+// sounding. Within a voice the mix is vectorised over time by MixKernels.
+// Audio thread only; never allocates.
+template <int MaxLanes>
+class VoiceBank
+{
+public:
+    static constexpr int kTileSize = 256;
+
+    VoiceBank() noexcept { clear(); }
+
+    void clear() noexcept
+    {
+        numActive = 0;
+        activePosition.fill (-1);
+    }
+
+    // Starts (or restarts) a lane reading from index up to length. The caller folds the point
+    // where the decay falls silent into length, so voices need no per-sample level checks.
+    // srcR may be null for a mono source.
+    void start (int lane, const float* srcLeft, const float* srcRight, int index, int length,
+                float envLevel, float envAlpha, int envElapsed) noexcept
+    {
+        start (lane, MixKernels::SourceFormat::float32, 1.0f, srcLeft, srcRight,
+               index, length, envLevel, envAlpha, envElapsed);
+    }
+
+    // As above for a source stored in format; every sample read is multiplied by sourceScale
+    // (the int16 dequantisation step, 1 otherwise).
+    void start (int lane, MixKernels::SourceFormat sourceFormat, float sourceScale,
+                const void* srcLeft, const void* srcRight, int index, int length,
+                float envLevel, float envAlpha, int envElapsed) noexcept
+    {
+        if (srcLeft == nullptr || index < 0 || index >= length)
+        {
+            stop (lane);
+            return;
+        }
+
+        format[(size_t) lane] = sourceFormat;
+        scale[(size_t) lane] = sourceScale;
+        srcL[(size_t) lane] = srcLeft;
+        srcR[(size_t) lane] = srcRight;
+        playIndex[(size_t) lane] = index;
+        playLength[(size_t) lane] = length;
+        env[(size_t) lane] = envLevel;
+        alpha[(size_t) lane] = envAlpha;
+        envSamplesElapsed[(size_t) lane] = envElapsed;
+
+        if (activePosition[(size_t) lane] < 0)
+        {
+            activePosition[(size_t) lane] = numActive;
+            activeLanes[(size_t) numActive++] = lane;
+        }
+    }
+
+    // gainMono is used instead of the panned pair when rendering to a mono destination
+    void setGains (int lane, float left, float right, float mono) noexcept
+    {
+        gainL[(size_t) lane] = left;
+        gainR[(size_t) lane] = right;
+        gainMono[(size_t) lane] = mono;
+    }
+
+    void stop (int lane) noexcept
+    {
+        const int pos = activePosition[(size_t) lane];
+        if (pos < 0)
+            return;
+
+        const int last = activeLanes[(size_t) (numActive - 1)];
+        activeLanes[(size_t) pos] = last;
+        activePosition[(size_t) last] = pos;
+        activePosition[(size_t) lane] = -1;
+        --numActive;
+    }
+
+    bool  isActive (int lane) const noexcept             { return activePosition[(size_t) lane] >= 0; }
+    int   getPlayIndex (int lane) const noexcept         { return playIndex[(size_t) lane]; }
+    float getEnvelope (int lane) const noexcept          { return env[(size_t) lane]; }
+    int   getEnvSamplesElapsed (int lane) const noexcept { return envSamplesElapsed[(size_t) lane]; }
+    int   getNumActive() const noexcept                  { return numActive; }
+
+    // Adds numSamples of every active voice to dst. dstR may be null for mono output.
+    // Voices that reach their length stop.
+    void render (float* dstL, float* dstR, int numSamples) noexcept
+    {
+        if (dstL == nullptr)
+            return;
+
+        for (int tileStart = 0; tileStart < numSamples && numActive > 0; tileStart += kTileSize)
+        {
+            const int tileLength = std::min (kTileSize, numSamples - tileStart);
+            float* tileL = dstL + tileStart;
+            float* tileR = dstR != nullptr ? dstR + tileStart : nullptr;
+
+            for (int a = 0; a < numActive; ++a)
+            {
+                const auto lane = (size_t) activeLanes[(size_t) a];
+                const int index = playIndex[lane];
+                const int n = std::min (tileLength, playLength[lane] - index);
+
+                const float gainLeft = (tileR != nullptr ? gainL[lane] : gainMono[lane]) * scale[lane];
+
+                MixKernels::EnvelopeState envState { env[lane], alpha[lane] };
+                MixKernels::mixSource (format[lane], srcL[lane], srcR[lane], index,
+                                       tileL, tileR, n,
+                                       gainLeft, gainR[lane] * scale[lane],
+                                       envState);
+                env[lane] = envState.level;
+                playIndex[lane] = index + n;
+                envSamplesElapsed[lane] += n;
+            }
+
+            retireFinished();
+        }
+    }
+
+    // Moves every active voice on by numSamples exactly as render() would, without mixing.
+    // Keeps voice state current while the output comes from somewhere else.
+    void advance (int numSamples) noexcept
+    {
+        for (int tileStart = 0; tileStart < numSamples && numActive > 0; tileStart += kTileSize)
+        {
+            const int tileLength = std::min (kTileSize, numSamples - tileStart);
+
+            for (int a = 0; a < numActive; ++a)
+            {
+                const auto lane = (size_t) activeLanes[(size_t) a];
+                const int n = std::min (tileLength, playLength[lane] - playIndex[lane]);
+
+                if (alpha[lane] != 1.0f)
+                    env[lane] *= std::pow (alpha[lane], (float) n);
+
+                playIndex[lane] += n;
+                envSamplesElapsed[lane] += n;
+            }
+
+            retireFinished();
+        }
+    }
+
+private:
+    void retireFinished() noexcept
+    {
+        for (int a = numActive; --a >= 0;)
+        {
+            const auto lane = (size_t) activeLanes[(size_t) a];
+            if (playIndex[lane] >= playLength[lane])
+                stop ((int) lane);
+        }
+    }
+
+    template <typename T>
+    using LaneArray = std::array<T, (size_t) MaxLanes>;
+
+    alignas (16) LaneArray<float> env {};
+    alignas (16) LaneArray<float> alpha {};
+    alignas (16) LaneArray<float> gainL {};
+    alignas (16) LaneArray<float> gainR {};
+    alignas (16) LaneArray<float> gainMono {};
+    alignas (16) LaneArray<float> scale {};
+    alignas (16) LaneArray<int> playIndex {};
+    alignas (16) LaneArray<int> playLength {};
+    alignas (16) LaneArray<int> envSamplesElapsed {};
+    LaneArray<const void*> srcL {};
+    LaneArray<const void*> srcR {};
+    LaneArray<MixKernels::SourceFormat> format {};
+
+    LaneArray<int> activeLanes {};
+    LaneArray<int> activePosition {};
+    int numActive = 0;
+};
@@ -0,0 +1,159 @@
+// Per-voice mix cost: the original scalar recursive-envelope loop against the
+// specialised kernels in Source/MixKernels.h, for each channel layout.
+//
+//   MixKernelBench [blockSize] [iterations]
+
+#include "MixKernels.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+namespace
+{
+    // Reference: the loop SlotVoice::mixInto used before the kernels
+    void mixScalarReference (const float* srcL, const float* srcR, float* dstL, float* dstR,
+                             int n, float gL, float gR, float& envLevel, float envAlpha)
+    {
+        if (dstR != nullptr && srcR != nullptr)
+        {
+            for (int i = 0; i < n; ++i)
+            {
+                const float envValue = envLevel;
+                dstL[i] += srcL[i] * gL * envValue;
+                dstR[i] += srcR[i] * gR * envValue;
+                envLevel *= envAlpha;
+            }
+        }
+        else if (dstR != nullptr)
+        {
+            for (int i = 0; i < n; ++i)
+            {
+                const float s = srcL[i];
+                const float envValue = envLevel;
+                dstL[i] += s * gL * envValue;
+                dstR[i] += s * gR * envValue;
+                envLevel *= envAlpha;
+            }
+        }
+        else
+        {
+            for (int i = 0; i < n; ++i)
+            {
+                dstL[i] += srcL[i] * gL * envLevel;
+                envLevel *= envAlpha;
+            }
+        }
+    }
+
+    struct Layout
+    {
+        const char* name;
+        bool stereoSource;
+        bool stereoDest;
+        float alpha;
+    };
+
+    template <typename Fn>
+    double timeNsPerSample (Fn&& fn, int blockSize, int iterations)
+    {
+        using Clock = std::chrono::steady_clock;
+        double best = 1.0e30;
+
+        for (int round = 0; round < 5; ++round)
+        {
+            const auto start = Clock::now();
+            for (int it = 0; it < iterations; ++it)
+                fn();
+            const auto elapsed = std::chrono::duration<double, std::nano> (Clock::now() - start).count();
+            best = std::min (best, elapsed / ((double) iterations * blockSize));
+        }
+
+        return best;
+    }
+}
+
+int main (int argc, char** argv)
+{
+    const int blockSize  = argc > 1 ? std::max (1, std::atoi (argv[1])) : 512;
+    const int iterations = argc > 2 ? std::max (1, std::atoi (argv[2])) : 20000;
+
+    std::mt19937 rng (1234);
+    std::uniform_real_distribution<float> dist (-1.0f, 1.0f);
+
+    std::vector<float> srcL ((size_t) blockSize), srcR ((size_t) blockSize);
+    for (int i = 0; i < blockSize; ++i)
+    {
+        srcL[(size_t) i] = dist (rng);
+        srcR[(size_t) i] = dist (rng);
+    }
+
+    std::vector<float> refL ((size_t) blockSize), refR ((size_t) blockSize);
+    std::vector<float> outL ((size_t) blockSize), outR ((size_t) blockSize);
+
+    const float alphaDecay = (float) std::pow (0.001, 1.0 / (0.25 * 48000.0)); // 250 ms at 48 kHz
+    const Layout layouts[] = {
+        { "stereo -> stereo, decay", true,  true,  alphaDecay },
+        { "mono   -> stereo, decay", false, true,  alphaDecay },
+        { "mono   -> mono,   decay", false, false, alphaDecay },
+        { "stereo -> stereo, flat ", true,  true,  1.0f },
+        { "mono   -> stereo, flat ", false, true,  1.0f },
+    };
+
+    std::printf ("block %d, %d iterations (best of 5)\n", blockSize, iterations);
+    std::printf ("%-26s %12s %12s %9s %12s\n", "layout", "scalar ns/s", "kernel ns/s", "speedup", "max |err|");
+
+    for (const auto& layout : layouts)
+    {
+        const float* sR = layout.stereoSource ? srcR.data() : nullptr;
+        float* rR = layout.stereoDest ? refR.data() : nullptr;
+        float* oR = layout.stereoDest ? outR.data() : nullptr;
+
+        // Accuracy over a single block from identical starting state
+        std::fill (refL.begin(), refL.end(), 0.0f);
+        std::fill (refR.begin(), refR.end(), 0.0f);
+        std::fill (outL.begin(), outL.end(), 0.0f);
+        std::fill (outR.begin(), outR.end(), 0.0f);
+
+        float refEnv = 0.9f;
+        mixScalarReference (srcL.data(), sR, refL.data(), rR, blockSize, 0.7f, 0.6f, refEnv, layout.alpha);
+
+        MixKernels::EnvelopeState env { 0.9f, layout.alpha };
+        MixKernels::mixVoice (srcL.data(), sR, outL.data(), oR, blockSize, 0.7f, 0.6f, env);
+
+        float maxErr = std::abs (env.level - refEnv);
+        for (int i = 0; i < blockSize; ++i)
+        {
+            maxErr = std::max (maxErr, std::abs (refL[(size_t) i] - outL[(size_t) i]));
+            maxErr = std::max (maxErr, std::abs (refR[(size_t) i] - outR[(size_t) i]));
+        }
+
+        // Timing: the envelope is reset each call so it never decays into denormals
+        const double scalarNs = timeNsPerSample ([&]
+        {
+            float e = 1.0f;
+            mixScalarReference (srcL.data(), sR, refL.data(), rR, blockSize, 0.7f, 0.6f, e, layout.alpha);
+        }, blockSize, iterations);
+
+        const double kernelNs = timeNsPerSample ([&]
+        {
+            MixKernels::EnvelopeState e { 1.0f, layout.alpha };
+            MixKernels::mixVoice (srcL.data(), sR, outL.data(), oR, blockSize, 0.7f, 0.6f, e);
+        }, blockSize, iterations);
+
+        std::printf ("%-26s %12.3f %12.3f %8.2fx %12.3g\n", layout.name, scalarNs, kernelNs,
+                     scalarNs / kernelNs, (double) maxErr);
+    }
+
+    // Keep the outputs observable so the loops are not optimised away
+    double sink = 0.0;
+    for (int i = 0; i < blockSize; ++i)
+        sink += refL[(size_t) i] + outL[(size_t) i] + refR[(size_t) i] + outR[(size_t) i];
+    std::printf ("(checksum %g)\n", sink);
+
+    return 0;
+}
@@ -0,0 +1,229 @@
+// processBlock throughput across block sizes, sample rates, timing modes and pattern
+// densities, with every block timed on its own so the worst case is reported alongside
+// the average. Results can be written as JSON to compare runs across commits:
+//
+//   ProcessBlockBench [--slots N] [--seconds S] [--quick] [--label TEXT] [--json FILE]
+//
+// --slots    slots holding a sample (default: all of the build's slots)
+// --seconds  audio rendered per case, after a quarter as much warm-up (default 2)
+// --quick    fewer block sizes and sample rates, for a fast check
+// --label    stored in the JSON, e.g. the commit being measured
+
+#include "ProcessorHarness.h"
+
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+namespace
+{
+    // How hard the pattern drives the engine: Rate and Beats/Cycle at their extremes,
+    // or the mixed polyrhythm the other harnesses use
+    enum class Density
+    {
+        sparse,
+        mixed,
+        dense
+    };
+
+    const char* getName(Density density)
+    {
+        switch (density)
+        {
+            case Density::sparse: return "sparse";
+            case Density::mixed:  return "mixed";
+            case Density::dense:  return "dense";
+        }
+
+        return "";
+    }
+
+    struct Case
+    {
+        int blockSize = 256;
+        double sampleRate = 48000.0;
+        int timingMode = 0; // 0 = Rate, 1 = Beats/Cycle
+        Density density = Density::mixed;
+    };
+
+    struct Result
+    {
+        Case config;
+        int numBlocks = 0;
+        double nsPerSample = 0.0;
+        double meanBlockNs = 0.0;
+        double worstBlockNs = 0.0;
+        double budgetNs = 0.0; // real time available for one block
+    };
+
+    void configurePattern(SlotMachineAudioProcessor& processor, const Case& config)
+    {
+        SlotHarness::configureDensePattern(processor, 120.0f);
+        SlotHarness::setParam(processor, "optTimingMode", (float)config.timingMode);
+
+        if (config.density == Density::mixed)
+            return;
+
+        const bool dense = config.density == Density::dense;
+        for (int i = 0; i < SlotHarness::kNumSlots; ++i)
+        {
+            SlotHarness::setParam(processor, SlotHarness::slotParamId(i, "Rate"), dense ? 4.0f : 0.0625f);
+            SlotHarness::setParam(processor, SlotHarness::slotParamId(i, "Count"), dense ? 64.0f : 1.0f);
+        }
+    }
+
+    Result measure(const Case& config, int activeSlots, double seconds)
+    {
+        SlotMachineAudioProcessor processor;
+        processor.setRateAndBufferSizeDetails(config.sampleRate, config.blockSize);
+        processor.prepareToPlay(config.sampleRate, config.blockSize);
+
+        SlotHarness::loadEmbeddedSamples(processor, activeSlots);
+        configurePattern(processor, config);
+
+        juce::AudioBuffer<float> buffer(SlotHarness::getNumOutputChannels(processor), config.blockSize);
+        juce::MidiBuffer midi;
+
+        const int numBlocks = juce::jmax(1, (int)(seconds * config.sampleRate / config.blockSize));
+
+        // Warm-up: fill tails and caches before timing
+        for (int b = 0; b < numBlocks / 4; ++b)
+        {
+            buffer.clear();
+            midi.clear();
+            processor.processBlock(buffer, midi);
+        }
+
+        using Clock = std::chrono::steady_clock;
+        double totalNs = 0.0;
+        double worstNs = 0.0;
+
+        for (int b = 0; b < numBlocks; ++b)
+        {
+            buffer.clear();
+            midi.clear();
+
+            const auto start = Clock::now();
+            processor.processBlock(buffer, midi);
+            const auto ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+
+            totalNs += ns;
+            worstNs = juce::jmax(worstNs, ns);
+        }
+
+        processor.releaseResources();
+
+        Result result;
+        result.config = config;
+        result.numBlocks = numBlocks;
+        result.nsPerSample = totalNs / ((double)numBlocks * config.blockSize);
+        result.meanBlockNs = totalNs / numBlocks;
+        result.worstBlockNs = worstNs;
+        result.budgetNs = 1.0e9 * config.blockSize / config.sampleRate;
+        return result;
+    }
+
+    juce::var toJson(const Result& r)
+    {
+        auto* obj = new juce::DynamicObject();
+        obj->setProperty("blockSize", r.config.blockSize);
+        obj->setProperty("sampleRate", r.config.sampleRate);
+        obj->setProperty("timingMode", r.config.timingMode == 0 ? "rate" : "count");
+        obj->setProperty("density", getName(r.config.density));
+        obj->setProperty("blocks", r.numBlocks);
+        obj->setProperty("nsPerSample", r.nsPerSample);
+        obj->setProperty("meanBlockNs", r.meanBlockNs);
+        obj->setProperty("worstBlockNs", r.worstBlockNs);
+        obj->setProperty("budgetNs", r.budgetNs);
+        return juce::var(obj);
+    }
+
+    bool writeJson(const juce::File& file, const juce::String& label, int activeSlots, double seconds,
+        const std::vector<Result>& results)
+    {
+        auto* root = new juce::DynamicObject();
+        root->setProperty("benchmark", "ProcessBlockBench");
+        root->setProperty("label", label);
+        root->setProperty("time", juce::Time::getCurrentTime().toISO8601(true));
+        root->setProperty("cpu", juce::SystemStats::getCpuModel());
+        root->setProperty("numSlots", SlotHarness::kNumSlots);
+        root->setProperty("activeSlots", activeSlots);
+        root->setProperty("secondsPerCase", seconds);
+
+        juce::Array<juce::var> cases;
+        for (const auto& r : results)
+            cases.add(toJson(r));
+        root->setProperty("cases", cases);
+
+        return file.replaceWithText(juce::JSON::toString(juce::var(root)));
+    }
+}
+
+int main(int argc, char** argv)
+{
+    juce::ScopedJuceInitialiser_GUI juceInit;
+
+    int activeSlots = SlotHarness::kNumSlots;
+    double seconds = 2.0;
+    bool quick = false;
+    juce::String label;
+    juce::File jsonFile;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const juce::String arg(argv[i]);
+        const bool hasValue = i + 1 < argc;
+
+        if (arg == "--slots" && hasValue)
+            activeSlots = juce::jlimit(0, SlotHarness::kNumSlots, juce::String(argv[++i]).getIntValue());
+        else if (arg == "--seconds" && hasValue)
+            seconds = juce::jmax(0.1, juce::String(argv[++i]).getDoubleValue());
+        else if (arg == "--label" && hasValue)
+            label = argv[++i];
+        else if (arg == "--json" && hasValue)
+            jsonFile = juce::File::getCurrentWorkingDirectory().getChildFile(argv[++i]);
+        else if (arg == "--quick")
+            quick = true;
+        else
+        {
+            std::fprintf(stderr, "usage: ProcessBlockBench [--slots N] [--seconds S] [--quick] [--label TEXT] [--json FILE]\n");
+            return 2;
+        }
+    }
+
+    const std::vector<int> blockSizes = quick ? std::vector<int>{ 16, 256, 4096 }
+                                              : std::vector<int>{ 16, 32, 64, 128, 256, 512, 1024, 2048, 4096 };
+    const std::vector<double> sampleRates = quick ? std::vector<double>{ 48000.0 }
+                                                  : std::vector<double>{ 44100.0, 48000.0, 96000.0 };
+
+    std::printf("build: %d slots, %d loaded, %.1f s of audio per case\n", SlotHarness::kNumSlots, activeSlots, seconds);
+    std::printf("%6s %7s %6s %7s %11s %12s %12s %11s\n",
+                "block", "rate", "mode", "density", "ns/sample", "mean ns", "worst ns", "worst % bud");
+
+    std::vector<Result> results;
+    for (const double sampleRate : sampleRates)
+        for (const int timingMode : { 0, 1 })
+            for (const auto density : { Density::sparse, Density::mixed, Density::dense })
+                for (const int blockSize : blockSizes)
+                {
+                    const auto r = measure({ blockSize, sampleRate, timingMode, density }, activeSlots, seconds);
+                    results.push_back(r);
+
+                    std::printf("%6d %7.0f %6s %7s %11.2f %12.0f %12.0f %10.2f%%\n",
+                                blockSize, sampleRate, timingMode == 0 ? "rate" : "count", getName(density),
+                                r.nsPerSample, r.meanBlockNs, r.worstBlockNs, 100.0 * r.worstBlockNs / r.budgetNs);
+                }
+
+    if (jsonFile != juce::File())
+    {
+        if (!writeJson(jsonFile, label, activeSlots, seconds, results))
+        {
+            std::fprintf(stderr, "could not write %s\n", jsonFile.getFullPathName().toRawUTF8());
+            return 1;
+        }
+
+        std::printf("wrote %s\n", jsonFile.getFullPathName().toRawUTF8());
+    }
+
+    return 0;
+}
@@ -0,0 +1,192 @@
+// Runs processBlock under randomised conditions in a SLOTMACHINE_RT_CHECK build and fails
+// if the audio thread allocated, freed or blocked at any point:
+//
+//   RealtimeSafetyDriver [runs] [seconds per run] [seed]
+//
+// Each run picks a sample rate, a maximum block size, offline or realtime mode and how many
+// slots hold a sample, then plays a dense pattern with varying block sizes while parameters
+// change, MIDI notes arrive and slots are clicked between blocks, as a host and editor would.
+// Runs take turns through the engine modes (serial, multi-core rendering, render-ahead, both,
+// and frozen-cycle playback), since those hand work to other threads or take another path
+// through the callback; the render-ahead thread runs the engine under the same check. Freeze
+// runs play at 120 BPM, where the cycle is a whole number of samples, and hold automation and
+// input back for their first 70% so a loop is captured and played before anything breaks it.
+// Exit status is 0 when no violation was recorded, 1 otherwise; the stacks go to stderr.
+
+#include "ProcessorHarness.h"
+#include "RealtimeSafetyCheck.h"
+
+#include <cstdio>
+#include <cstdlib>
+
+namespace
+{
+    constexpr double kSampleRates[] = { 44100.0, 48000.0, 88200.0, 96000.0 };
+    constexpr int kMaxBlockSizes[] = { 32, 64, 128, 256, 512, 1024, 2048 };
+    constexpr int kMidiBufferBytes = 64 * 1024; // hosts hand over a pre-sized MidiBuffer
+
+    struct EngineMode
+    {
+        const char* name;
+        bool parallelRender;
+        bool renderAhead;
+        bool freeze;
+    };
+
+    constexpr EngineMode kEngineModes[] = {
+        { "serial",            false, false, false },
+        { "multi-core",        true,  false, false },
+        { "render-ahead",      false, true,  false },
+        { "multi-core+ahead",  true,  true,  false },
+        { "freeze",            false, false, true }
+    };
+
+    constexpr float kFreezeBpm = 120.0f;
+    constexpr double kFreezeCalmFraction = 0.7;
+
+    // Chosen per run, never by randomiseParameters
+    const juce::StringArray kEngineModeParams { "optParallelRender", "optRenderAhead", "optFreezePatterns" };
+
+    template <typename T, size_t N>
+    const T& pick(juce::Random& rng, const T (&values)[N])
+    {
+        return values[(size_t)rng.nextInt((int)N)];
+    }
+
+    // Moves a few parameters to random values, the way host automation or the editor would
+    void randomiseParameters(SlotMachineAudioProcessor& processor, juce::Random& rng)
+    {
+        const auto& params = processor.getParameters();
+        if (params.isEmpty())
+            return;
+
+        for (int n = 1 + rng.nextInt(4); --n >= 0;)
+        {
+            auto* param = params[rng.nextInt(params.size())];
+            if (auto* withId = dynamic_cast<juce::AudioProcessorParameterWithID*>(param))
+                if (kEngineModeParams.contains(withId->paramID))
+                    continue;
+
+            param->setValueNotifyingHost(rng.nextFloat());
+        }
+
+        // Keep the transport running most of the time; a stopped engine checks very little
+        if (rng.nextInt(10) != 0)
+            SlotHarness::setParam(processor, "masterRun", 1.0f);
+    }
+
+    void addRandomNotes(SlotMachineAudioProcessor& processor, juce::MidiBuffer& midi, juce::Random& rng, int numSamples)
+    {
+        for (int n = rng.nextInt(4); --n >= 0;)
+        {
+            const int slot = rng.nextInt(SlotHarness::kNumSlots);
+            const int note = juce::jlimit(0, 127,
+                (int)SlotHarness::getParam(processor, SlotHarness::slotParamId(slot, "TriggerNote")));
+            const int offset = rng.nextInt(numSamples);
+
+            midi.addEvent(juce::MidiMessage::noteOn(1, note, (juce::uint8)(1 + rng.nextInt(127))), offset);
+            midi.addEvent(juce::MidiMessage::noteOff(1, note), juce::jmin(numSamples - 1, offset + 1));
+        }
+    }
+
+    // Returns the number of violations recorded during the run
+    int runOnce(int runIndex, juce::Random& rng, double seconds)
+    {
+        const auto& mode = kEngineModes[(size_t)runIndex % std::size(kEngineModes)];
+        const double sampleRate = pick(rng, kSampleRates);
+        int maxBlockSize = pick(rng, kMaxBlockSizes);
+        const bool offline = rng.nextInt(4) == 0;
+        int loadedSlots = rng.nextInt(SlotHarness::kNumSlots + 1);
+
+        // Multi-core rendering needs more than one live group and blocks long enough to split
+        if (mode.parallelRender)
+        {
+            maxBlockSize = juce::jmax(maxBlockSize, 4 * SlotMachineAudioProcessor::kMinParallelRenderBlock);
+            loadedSlots = juce::jmax(loadedSlots, juce::jmin(SlotHarness::kNumSlots,
+                                                             2 * SlotMachineAudioProcessor::kSlotsPerRenderGroup));
+        }
+
+        SlotMachineAudioProcessor processor;
+        SlotHarness::setParam(processor, "optParallelRender", mode.parallelRender ? 1.0f : 0.0f);
+        SlotHarness::setParam(processor, "optRenderAhead", mode.renderAhead ? 1.0f : 0.0f);
+        SlotHarness::setParam(processor, "optFreezePatterns", mode.freeze ? 1.0f : 0.0f);
+        processor.setNonRealtime(offline);
+        processor.setRateAndBufferSizeDetails(sampleRate, maxBlockSize);
+        processor.prepareToPlay(sampleRate, maxBlockSize);
+
+        SlotHarness::loadEmbeddedSamples(processor, loadedSlots);
+        SlotHarness::configureDensePattern(processor, mode.freeze ? kFreezeBpm : 60.0f + 180.0f * rng.nextFloat());
+
+        const int numChannels = SlotHarness::getNumOutputChannels(processor);
+        juce::AudioBuffer<float> buffer(numChannels, maxBlockSize);
+        juce::MidiBuffer midi;
+        midi.ensureSize(kMidiBufferBytes);
+
+        const int violationsBefore = RealtimeSafety::getNumViolations();
+        const juce::int64 totalSamples = (juce::int64)(seconds * sampleRate);
+        const juce::int64 calmSamples = mode.freeze ? (juce::int64)((double)totalSamples * kFreezeCalmFraction) : 0;
+        juce::int64 samplesLeft = totalSamples;
+        int numBlocks = 0;
+
+        while (samplesLeft > 0)
+        {
+            // Hosts may pass anything up to the size given to prepareToPlay
+            const int numSamples = (int)juce::jmin((juce::int64)(1 + rng.nextInt(maxBlockSize)), samplesLeft);
+            const bool calm = totalSamples - samplesLeft < calmSamples;
+
+            if (!calm && rng.nextInt(8) == 0)
+                randomiseParameters(processor, rng);
+
+            if (!calm && rng.nextInt(16) == 0)
+                processor.requestManualTrigger(rng.nextInt(SlotHarness::kNumSlots));
+
+            midi.clear();
+            if (!calm && rng.nextInt(4) == 0)
+                addRandomNotes(processor, midi, rng, numSamples);
+
+            juce::AudioBuffer<float> block(buffer.getArrayOfWritePointers(), numChannels, numSamples);
+            block.clear();
+            processor.processBlock(block, midi);
+
+            samplesLeft -= numSamples;
+            ++numBlocks;
+        }
+
+        processor.releaseResources();
+
+        const int violations = RealtimeSafety::getNumViolations() - violationsBefore;
+        std::printf("run %3d: %-16s %6.0f Hz, blocks <= %4d, %-8s %2d slots loaded, %7d blocks: %d violation(s)\n",
+                    runIndex, mode.name, sampleRate, maxBlockSize, offline ? "offline," : "realtime,",
+                    loadedSlots, numBlocks, violations);
+        return violations;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    juce::ScopedJuceInitialiser_GUI juceInit;
+
+    static_assert(RealtimeSafety::isEnabled(), "RealtimeSafetyDriver must be built with SLOTMACHINE_RT_CHECK=1");
+
+    const int runs = argc > 1 ? juce::jmax(1, std::atoi(argv[1])) : 20;
+    const double seconds = argc > 2 ? juce::jmax(0.1, std::atof(argv[2])) : 10.0;
+    const juce::int64 seed = argc > 3 ? (juce::int64)std::atoll(argv[3]) : juce::Time::currentTimeMillis();
+
+    std::printf("build: %d slots, %d run(s) of %.1f s, seed %lld\n",
+                SlotHarness::kNumSlots, runs, seconds, (long long)seed);
+
+    juce::Random rng(seed);
+    int violations = 0;
+    for (int run = 0; run < runs; ++run)
+        violations += runOnce(run, rng, seconds);
+
+    if (violations == 0)
+    {
+        std::printf("no allocation, free or blocking call inside processBlock\n");
+        return 0;
+    }
+
+    std::fprintf(stderr, "%d violation(s) inside processBlock (rerun with seed %lld to reproduce):\n%s",
+                 violations, (long long)seed, RealtimeSafety::describeViolations().toRawUTF8());
+    return 1;
+}
@@ -0,0 +1,402 @@
+// Null test between the realtime engine and the offline export. The same preset is rendered
+// through processBlock at several block sizes (and with the render options that should not
+// change the output) and through exportAudioCycles, then:
+//
+//  - every realtime render is compared sample by sample with the export and with the first
+//    realtime render, and
+//  - every realtime hit, read back from the MIDI notes processBlock emits, is checked
+//    against the exact rational schedule: hit k of a slot at Rate n/d lands on beat k*d/n,
+//    and step k of a slot with Beats/Cycle c on beat k*4/c.
+//
+//   RenderNullTest [--slots N] [--cycles C] [--bpm B] [--rate 44100|48000]
+//                  [--hit-tolerance SAMPLES] [--audio-tolerance LINEAR]
+//
+// Both timing modes are tested. Exit status is 0 when everything matches within tolerance.
+// The export is 24-bit, so the default audio tolerance is two 24-bit steps, and its last
+// kExportFadeSamples are left out because the export fades out any tail that runs past the end.
+//
+// Frozen-cycle playback repeats the first loop it captured, which the engine accepts once the
+// second loop matches it within kFrozenLoopTolerance, so the freeze variant is held to that
+// tolerance instead. Capture takes two loops (a loop is one 4-beat cycle of the test preset)
+// after a settling block, so at least kMinFreezeCycles are rendered to reach playback.
+
+#include "ProcessorHarness.h"
+
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+namespace
+{
+    constexpr int kMaxTestSlots = 16;             // slots are told apart by MIDI channel
+    constexpr int kExportFadeSamples = 512;
+    constexpr int kMaxRateDenominator = 32;       // as the engine approximates Rate
+    constexpr int kMinFreezeCycles = 4;           // two captured loops, then two played back
+
+    struct Settings
+    {
+        int numSlots = 8;
+        int cycles = kMinFreezeCycles;
+        int bpm = 120;
+        int sampleRate = 48000;
+        juce::int64 hitTolerance = 0;
+        double audioTolerance = 2.0 / 8388608.0;
+    };
+
+    struct Variant
+    {
+        juce::String name;
+        int blockSize = 256;
+        bool parallel = false;
+        bool freeze = false;
+    };
+
+    struct Render
+    {
+        juce::AudioBuffer<float> audio;
+        std::vector<std::vector<juce::int64>> hits;   // per slot, absolute sample positions
+    };
+
+    struct Rational
+    {
+        juce::int64 num = 0;
+        juce::int64 den = 1;
+    };
+
+    // Closest fraction with a denominator up to maxDen
+    Rational toRational(double value, int maxDen)
+    {
+        Rational best{ (juce::int64)std::llround(value), 1 };
+        double bestError = std::abs(value - (double)best.num);
+
+        for (int den = 2; den <= maxDen; ++den)
+        {
+            const auto num = (juce::int64)std::llround(value * den);
+            const double error = std::abs(value - (double)num / den);
+            if (error < bestError - 1.0e-12)
+            {
+                best = { num, den };
+                bestError = error;
+            }
+        }
+
+        return best;
+    }
+
+    // round(beatsNum / beatsDen * 60 / bpm * sampleRate), in integers
+    juce::int64 beatToSample(juce::int64 beatsNum, juce::int64 beatsDen, const Settings& settings)
+    {
+        const juce::int64 n = beatsNum * 60 * settings.sampleRate;
+        const juce::int64 d = beatsDen * settings.bpm;
+        return (2 * n + d) / (2 * d);
+    }
+
+    void configurePreset(SlotMachineAudioProcessor& processor, const juce::Array<juce::File>& files,
+        const Settings& settings, int timingMode, const Variant& variant)
+    {
+        static constexpr float counts[] = { 4.0f, 3.0f, 5.0f, 8.0f, 6.0f, 7.0f, 16.0f, 12.0f };
+
+        for (int slot = 0; slot < settings.numSlots && slot < files.size(); ++slot)
+            processor.loadSampleForSlot(slot, files[slot]);
+
+        SlotHarness::configureDensePattern(processor, (float)settings.bpm);
+        SlotHarness::setParam(processor, "optTimingMode", (float)timingMode);
+        SlotHarness::setParam(processor, "optSampleRate", (float)settings.sampleRate);
+        SlotHarness::setParam(processor, "optParallelRender", variant.parallel ? 1.0f : 0.0f);
+        SlotHarness::setParam(processor, "optFreezePatterns", variant.freeze ? 1.0f : 0.0f);
+
+        for (int slot = 0; slot < SlotHarness::kNumSlots; ++slot)
+        {
+            SlotHarness::setParam(processor, SlotHarness::slotParamId(slot, "Count"), counts[slot % (int)std::size(counts)]);
+            SlotHarness::setParam(processor, SlotHarness::slotParamId(slot, "MidiChannel"), (float)juce::jmin(slot, 15));
+        }
+    }
+
+    Render renderRealtime(const juce::Array<juce::File>& files, const Settings& settings, int timingMode,
+        const Variant& variant, int numSamples)
+    {
+        SlotMachineAudioProcessor processor;
+        processor.setNonRealtime(true);
+        processor.setRateAndBufferSizeDetails(settings.sampleRate, variant.blockSize);
+
+        // The engine only allocates the frozen loop when the option is on at prepare
+        SlotHarness::setParam(processor, "optFreezePatterns", variant.freeze ? 1.0f : 0.0f);
+        processor.prepareToPlay(settings.sampleRate, variant.blockSize);
+        configurePreset(processor, files, settings, timingMode, variant);
+
+        Render render;
+        render.audio.setSize(2, numSamples);
+        render.audio.clear();
+        render.hits.resize((size_t)settings.numSlots);
+
+        juce::AudioBuffer<float> block(juce::jmax(2, SlotHarness::getNumOutputChannels(processor)), variant.blockSize);
+        juce::MidiBuffer midi;
+
+        for (int start = 0; start < numSamples; start += variant.blockSize)
+        {
+            block.clear();
+            midi.clear();
+            processor.processBlock(block, midi);
+
+            for (const auto metadata : midi)
+            {
+                const auto message = metadata.getMessage();
+                const int slot = message.getChannel() - 1;
+                const int position = start + metadata.samplePosition;
+                if (message.isNoteOn() && slot >= 0 && slot < settings.numSlots && position < numSamples)
+                    render.hits[(size_t)slot].push_back(position);
+            }
+
+            const int toCopy = juce::jmin(variant.blockSize, numSamples - start);
+            for (int ch = 0; ch < 2; ++ch)
+                render.audio.copyFrom(ch, start, block, ch, 0, toCopy);
+        }
+
+        processor.releaseResources();
+        return render;
+    }
+
+    bool renderExport(const juce::Array<juce::File>& files, const Settings& settings, int timingMode,
+        const juce::File& destination, juce::AudioBuffer<float>& audio)
+    {
+        SlotMachineAudioProcessor processor;
+        processor.prepareToPlay(settings.sampleRate, 512);
+        configurePreset(processor, files, settings, timingMode, {});
+
+        juce::String error;
+        if (!processor.exportAudioCycles(destination, settings.cycles, error))
+        {
+            std::printf("export failed: %s\n", error.toRawUTF8());
+            return false;
+        }
+
+        juce::AudioFormatManager formats;
+        formats.registerBasicFormats();
+        std::unique_ptr<juce::AudioFormatReader> reader(formats.createReaderFor(destination));
+        if (reader == nullptr)
+            return false;
+
+        audio.setSize(2, (int)reader->lengthInSamples);
+        audio.clear();
+        reader->read(&audio, 0, (int)reader->lengthInSamples, 0, true, reader->numChannels > 1);
+        return true;
+    }
+
+    // Exact hit positions for each test slot, up to numSamples
+    std::vector<std::vector<juce::int64>> expectedHits(SlotMachineAudioProcessor& processor, const Settings& settings,
+        int timingMode, int numSamples)
+    {
+        std::vector<std::vector<juce::int64>> hits((size_t)settings.numSlots);
+
+        for (int slot = 0; slot < settings.numSlots; ++slot)
+        {
+            auto& out = hits[(size_t)slot];
+
+            if (timingMode == 0)
+            {
+                const auto rate = toRational(SlotHarness::getParam(processor, SlotHarness::slotParamId(slot, "Rate")),
+                    kMaxRateDenominator);
+
+                for (juce::int64 k = 0;; ++k)
+                {
+                    const auto position = beatToSample(k * rate.den, rate.num, settings);
+                    if (position >= numSamples)
+                        break;
+                    out.push_back(position);
+                }
+            }
+            else
+            {
+                const int count = juce::jlimit(1, 64,
+                    (int)std::round(SlotHarness::getParam(processor, SlotHarness::slotParamId(slot, "Count"))));
+                const uint64_t mask = processor.getSlotCountMask(slot) & SlotMachineAudioProcessor::maskForBeats(count);
+
+                for (juce::int64 k = 0;; ++k)
+                {
+                    const auto position = beatToSample(k * SlotMachineAudioProcessor::kCountModeBaseBeats, count, settings);
+                    if (position >= numSamples)
+                        break;
+                    if (((mask >> (k % count)) & 1ull) != 0)
+                        out.push_back(position);
+                }
+            }
+        }
+
+        return hits;
+    }
+
+    struct AudioDiff
+    {
+        double maxDiff = 0.0;
+        int firstBadSample = -1;
+    };
+
+    AudioDiff compareAudio(const juce::AudioBuffer<float>& a, const juce::AudioBuffer<float>& b, int numSamples, double tolerance)
+    {
+        AudioDiff diff;
+
+        for (int ch = 0; ch < 2; ++ch)
+        {
+            const float* x = a.getReadPointer(ch);
+            const float* y = b.getReadPointer(ch);
+
+            for (int i = 0; i < numSamples; ++i)
+            {
+                const double d = std::abs((double)x[i] - (double)y[i]);
+                diff.maxDiff = juce::jmax(diff.maxDiff, d);
+                if (d > tolerance && (diff.firstBadSample < 0 || i < diff.firstBadSample))
+                    diff.firstBadSample = i;
+            }
+        }
+
+        return diff;
+    }
+
+    struct HitCheck
+    {
+        int numHits = 0;
+        int mismatchedCounts = 0;     // slots whose number of hits differs from the schedule
+        juce::int64 maxError = 0;     // worst placement among slots with the right count
+    };
+
+    HitCheck checkHits(const std::vector<std::vector<juce::int64>>& actual, const std::vector<std::vector<juce::int64>>& expected)
+    {
+        HitCheck check;
+
+        for (size_t slot = 0; slot < expected.size(); ++slot)
+        {
+            check.numHits += (int)actual[slot].size();
+
+            if (actual[slot].size() != expected[slot].size())
+            {
+                ++check.mismatchedCounts;
+                continue;
+            }
+
+            for (size_t k = 0; k < expected[slot].size(); ++k)
+                check.maxError = juce::jmax(check.maxError, std::abs(actual[slot][k] - expected[slot][k]));
+        }
+
+        return check;
+    }
+
+    juce::String toDb(double linear)
+    {
+        return linear > 0.0 ? juce::String(juce::Decibels::gainToDecibels(linear, -300.0), 1) + " dB" : juce::String("exact");
+    }
+
+    // Returns true when every variant matches the export, the reference render and the schedule
+    bool testTimingMode(const juce::Array<juce::File>& files, const Settings& settings, int timingMode,
+        const std::vector<Variant>& variants, const juce::File& exportFile)
+    {
+        std::printf("\n%s mode, %d slots, %d cycle(s) at %d BPM, %d Hz\n",
+                    timingMode == 0 ? "Rate" : "Beats/Cycle", settings.numSlots, settings.cycles, settings.bpm, settings.sampleRate);
+
+        juce::AudioBuffer<float> exported;
+        if (!renderExport(files, settings, timingMode, exportFile, exported))
+            return false;
+
+        const int numSamples = exported.getNumSamples();
+        const int comparedSamples = juce::jmax(0, numSamples - kExportFadeSamples);
+
+        std::vector<std::vector<juce::int64>> expected;
+        {
+            SlotMachineAudioProcessor processor;
+            configurePreset(processor, files, settings, timingMode, {});
+            expected = expectedHits(processor, settings, timingMode, numSamples);
+        }
+
+        std::printf("%-16s %14s %10s %14s %10s %6s %10s\n",
+                    "variant", "vs export", "first bad", "vs reference", "first bad", "hits", "hit error");
+
+        bool ok = true;
+        juce::AudioBuffer<float> reference;
+
+        for (const auto& variant : variants)
+        {
+            auto render = renderRealtime(files, settings, timingMode, variant, numSamples);
+            if (reference.getNumSamples() == 0)
+                reference.makeCopyOf(render.audio);
+
+            const double tolerance = variant.freeze
+                ? juce::jmax(settings.audioTolerance, (double)SlotMachineAudioProcessor::kFrozenLoopTolerance)
+                : settings.audioTolerance;
+            const auto vsExport = compareAudio(render.audio, exported, comparedSamples, tolerance);
+            const auto vsReference = compareAudio(render.audio, reference, numSamples, tolerance);
+            const auto hits = checkHits(render.hits, expected);
+
+            const bool hitsOk = hits.mismatchedCounts == 0 && hits.maxError <= settings.hitTolerance;
+            ok = ok && vsExport.firstBadSample < 0 && vsReference.firstBadSample < 0 && hitsOk;
+
+            std::printf("%-16s %14s %10d %14s %10d %6d %10s\n",
+                        variant.name.toRawUTF8(),
+                        toDb(vsExport.maxDiff).toRawUTF8(), vsExport.firstBadSample,
+                        toDb(vsReference.maxDiff).toRawUTF8(), vsReference.firstBadSample,
+                        hits.numHits,
+                        hits.mismatchedCounts > 0 ? (juce::String(hits.mismatchedCounts) + " slot(s) off").toRawUTF8()
+                                                  : (juce::String(hits.maxError) + " smp").toRawUTF8());
+        }
+
+        return ok;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    juce::ScopedJuceInitialiser_GUI juceInit;
+
+    Settings settings;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const juce::String arg(argv[i]);
+        const bool hasValue = i + 1 < argc;
+
+        if (arg == "--slots" && hasValue)
+            settings.numSlots = juce::jlimit(1, juce::jmin(kMaxTestSlots, SlotHarness::kNumSlots), juce::String(argv[++i]).getIntValue());
+        else if (arg == "--cycles" && hasValue)
+            settings.cycles = juce::jlimit(1, 64, juce::String(argv[++i]).getIntValue());
+        else if (arg == "--bpm" && hasValue)
+            settings.bpm = juce::jlimit(20, 400, juce::String(argv[++i]).getIntValue());
+        else if (arg == "--rate" && hasValue)
+            settings.sampleRate = juce::String(argv[++i]).getIntValue() == 44100 ? 44100 : 48000;
+        else if (arg == "--hit-tolerance" && hasValue)
+            settings.hitTolerance = juce::jmax<juce::int64>(0, juce::String(argv[++i]).getLargeIntValue());
+        else if (arg == "--audio-tolerance" && hasValue)
+            settings.audioTolerance = juce::jmax(0.0, juce::String(argv[++i]).getDoubleValue());
+        else
+        {
+            std::fprintf(stderr, "usage: RenderNullTest [--slots N] [--cycles C] [--bpm B] [--rate 44100|48000] "
+                                 "[--hit-tolerance SAMPLES] [--audio-tolerance LINEAR]\n");
+            return 2;
+        }
+    }
+
+    // Block sizes that divide the cycle and ones that do not, then the options that must not
+    // change the output at a typical size
+    std::vector<Variant> variants;
+    for (const int blockSize : { 1, 32, 64, 128, 256, 441, 512, 1000, 4096 })
+        variants.push_back({ "block " + juce::String(blockSize), blockSize, false, false });
+    variants.push_back({ "block 256 par", 256, true, false });
+    variants.push_back({ "block 256 freeze", 256, false, true });
+
+    if (settings.cycles < kMinFreezeCycles)
+    {
+        std::printf("rendering %d cycles so the freeze variant reaches frozen playback\n", kMinFreezeCycles);
+        settings.cycles = kMinFreezeCycles;
+    }
+
+    const auto workDir = juce::File::getSpecialLocation(juce::File::tempDirectory)
+                             .getChildFile("SlotMachineNullTest-" + juce::String(juce::Time::currentTimeMillis()));
+    const auto files = SlotHarness::writeEmbeddedSampleFiles(workDir, settings.numSlots);
+    settings.numSlots = juce::jmin(settings.numSlots, files.size());
+
+    bool ok = settings.numSlots > 0;
+    for (const int timingMode : { 0, 1 })
+        ok = testTimingMode(files, settings, timingMode, variants, workDir.getChildFile("export.wav")) && ok;
+
+    workDir.deleteRecursively();
+
+    std::printf("\n%s\n", ok ? "PASS: realtime and export renders match" : "FAIL: renders differ (see above)");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,72 @@
+// processBlock cost against the number of slots holding a sample, for a build with
+// SLOTMACHINE_NUM_SLOTS slots. Run the 16, 32 and 64 builds side by side to see how
+// the engine scales:
+//
+//   SlotScalingBench64 [blockSize] [seconds]
+
+#include "ProcessorHarness.h"
+
+#include <chrono>
+#include <cstdio>
+
+namespace
+{
+    double measureNsPerBlock(int activeSlots, int blockSize, double sampleRate, double seconds)
+    {
+        SlotMachineAudioProcessor processor;
+        processor.setRateAndBufferSizeDetails(sampleRate, blockSize);
+        processor.prepareToPlay(sampleRate, blockSize);
+
+        SlotHarness::loadEmbeddedSamples(processor, activeSlots);
+        SlotHarness::configureDensePattern(processor, 180.0f);
+
+        juce::AudioBuffer<float> buffer(SlotHarness::getNumOutputChannels(processor), blockSize);
+        juce::MidiBuffer midi;
+
+        const int numBlocks = juce::jmax(1, (int)(seconds * sampleRate / blockSize));
+
+        // Warm-up: fill tails and caches before timing
+        for (int b = 0; b < numBlocks / 4; ++b)
+        {
+            buffer.clear();
+            midi.clear();
+            processor.processBlock(buffer, midi);
+        }
+
+        using Clock = std::chrono::steady_clock;
+        const auto start = Clock::now();
+
+        for (int b = 0; b < numBlocks; ++b)
+        {
+            buffer.clear();
+            midi.clear();
+            processor.processBlock(buffer, midi);
+        }
+
+        const auto elapsed = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+        processor.releaseResources();
+        return elapsed / numBlocks;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    juce::ScopedJuceInitialiser_GUI juceInit;
+
+    const int blockSize = argc > 1 ? juce::jmax(1, std::atoi(argv[1])) : 256;
+    const double seconds = argc > 2 ? juce::jmax(0.1, std::atof(argv[2])) : 20.0;
+    const double sampleRate = 48000.0;
+    const double blockBudgetNs = 1.0e9 * blockSize / sampleRate;
+
+    std::printf("build: %d slots, block %d @ %.0f Hz, %.1f s of audio per row\n",
+                SlotHarness::kNumSlots, blockSize, sampleRate, seconds);
+    std::printf("%8s %14s %12s\n", "active", "ns/block", "% of budget");
+
+    for (int active = 0; active <= SlotHarness::kNumSlots; active = (active == 0 ? 4 : active * 2))
+    {
+        const double ns = measureNsPerBlock(active, blockSize, sampleRate, seconds);
+        std::printf("%8d %14.0f %11.3f%%\n", active, ns, 100.0 * ns / blockBudgetNs);
+    }
+
+    return 0;
+}
@@ -0,0 +1,359 @@
+// Soak test for worst-case block time and memory growth. processBlock runs back to back
+// for hours of simulated audio while a second thread, standing in for the editor and the
+// host, automates parameters, switches patterns, clicks slots and swaps samples:
+//
+//   SoakHarness [--hours H] [--block N] [--rate SR] [--seed S]
+//               [--max-block-ms X] [--max-rss-growth-mb Y]
+//
+// Prints a histogram of block times, the worst block and resident memory over time. With
+// --max-block-ms or --max-rss-growth-mb the exit status is 1 if the limit was exceeded.
+// Resident memory is read from /proc, so it is only reported on Linux.
+
+#include "ProcessorHarness.h"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+#if JUCE_LINUX
+#include <unistd.h>
+#endif
+
+namespace
+{
+    constexpr int kNumPatterns = 4;
+    constexpr int kNumSampleFiles = 12;
+    constexpr int kNumHistogramBuckets = 24;      // bucket b holds blocks taking [2^(b-1), 2^b) us
+    constexpr double kMeanEventIntervalSeconds = 0.05;
+    constexpr double kReportIntervalSeconds = 600.0;
+    constexpr double kWarmUpSeconds = 60.0;       // memory growth is measured from here
+
+    juce::int64 getResidentBytes()
+    {
+#if JUCE_LINUX
+        const auto fields = juce::StringArray::fromTokens(juce::File("/proc/self/statm").loadFileAsString(), false);
+        if (fields.size() > 1)
+            return fields[1].getLargeIntValue() * (juce::int64)sysconf(_SC_PAGESIZE);
+#endif
+        return 0;
+    }
+
+    // Does what the editor and host would, paced by the simulated clock the audio loop advances
+    class ControlThread : public juce::Thread
+    {
+    public:
+        ControlThread(SlotMachineAudioProcessor& p, const juce::Array<juce::File>& sampleFiles,
+            const std::atomic<double>& clock, juce::int64 seed)
+            : juce::Thread("Soak control"), processor(p), files(sampleFiles), simulatedSeconds(clock), rng(seed)
+        {
+        }
+
+        void run() override
+        {
+            double nextEvent = 0.0;
+
+            while (!threadShouldExit())
+            {
+                if (simulatedSeconds.load(std::memory_order_relaxed) < nextEvent)
+                {
+                    wait(1);
+                    continue;
+                }
+
+                performRandomEvent();
+                nextEvent += 2.0 * kMeanEventIntervalSeconds * rng.nextDouble();
+            }
+        }
+
+        std::array<int, 4> getEventCounts() const noexcept
+        {
+            return { numAutomations.load(), numTriggers.load(), numSampleSwaps.load(), numPatternSwitches.load() };
+        }
+
+    private:
+        void performRandomEvent()
+        {
+            const int choice = rng.nextInt(100);
+
+            if (choice < 55)
+                automate();
+            else if (choice < 75)
+                trigger();
+            else if (choice < 92)
+                swapSample();
+            else
+                switchPattern();
+        }
+
+        void automate()
+        {
+            const auto& params = processor.getParameters();
+            for (int n = 1 + rng.nextInt(3); --n >= 0;)
+                params[rng.nextInt(params.size())]->setValueNotifyingHost(rng.nextFloat());
+
+            // A stopped transport would leave most of the engine idle
+            if (rng.nextInt(20) != 0)
+                SlotHarness::setParam(processor, "masterRun", 1.0f);
+
+            ++numAutomations;
+        }
+
+        void trigger()
+        {
+            processor.requestManualTrigger(rng.nextInt(SlotHarness::kNumSlots));
+            ++numTriggers;
+        }
+
+        void swapSample()
+        {
+            const int slot = rng.nextInt(SlotHarness::kNumSlots);
+
+            if (files.isEmpty() || rng.nextInt(8) == 0)
+                processor.clearSlot(slot, true);
+            else
+                processor.loadSampleForSlot(slot, files[rng.nextInt(files.size())], true);
+
+            ++numSampleSwaps;
+        }
+
+        void switchPattern()
+        {
+            auto patterns = processor.getPatternsTree();
+            if (patterns.getNumChildren() <= 0)
+                return;
+
+            // As the editor does: keep edits in the pattern being left, then apply the new one
+            processor.storeCurrentStateInPattern(patterns.getChild(processor.getCurrentPatternIndex()));
+
+            const int index = rng.nextInt(patterns.getNumChildren());
+            processor.setCurrentPatternIndex(index);
+            processor.applyPatternTree(patterns.getChild(index), nullptr, true);
+
+            ++numPatternSwitches;
+        }
+
+        SlotMachineAudioProcessor& processor;
+        const juce::Array<juce::File>& files;
+        const std::atomic<double>& simulatedSeconds;
+        juce::Random rng;
+
+        std::atomic<int> numAutomations{ 0 }, numTriggers{ 0 }, numSampleSwaps{ 0 }, numPatternSwitches{ 0 };
+    };
+
+    // A few patterns that differ in rates, counts and samples, for the control thread to switch between
+    void createPatterns(SlotMachineAudioProcessor& processor, const juce::Array<juce::File>& files, juce::Random& rng)
+    {
+        auto patterns = processor.getPatternsTree();
+
+        for (int p = 0; p < kNumPatterns; ++p)
+        {
+            for (int slot = 0; slot < SlotHarness::kNumSlots; ++slot)
+            {
+                if (!files.isEmpty())
+                    processor.loadSampleForSlot(slot, files[(slot + p) % files.size()]);
+
+                SlotHarness::setParam(processor, SlotHarness::slotParamId(slot, "Rate"), 0.25f + 3.75f * rng.nextFloat());
+                SlotHarness::setParam(processor, SlotHarness::slotParamId(slot, "Count"), (float)(1 + rng.nextInt(16)));
+            }
+
+            if (p < patterns.getNumChildren())
+                processor.storeCurrentStateInPattern(patterns.getChild(p));
+            else
+                patterns.addChild(processor.createPatternTreeFromCurrentState("Soak " + juce::String(p + 1)), -1, nullptr);
+        }
+
+        processor.setCurrentPatternIndex(kNumPatterns - 1);
+    }
+
+    struct MemorySample
+    {
+        double simulatedSeconds = 0.0;
+        juce::int64 residentBytes = 0;
+    };
+
+    // Least-squares slope of resident memory over simulated time, in MB per hour
+    double getGrowthMbPerHour(const std::vector<MemorySample>& samples)
+    {
+        if (samples.size() < 2)
+            return 0.0;
+
+        double meanT = 0.0, meanM = 0.0;
+        for (const auto& s : samples)
+        {
+            meanT += s.simulatedSeconds;
+            meanM += (double)s.residentBytes;
+        }
+        meanT /= (double)samples.size();
+        meanM /= (double)samples.size();
+
+        double num = 0.0, den = 0.0;
+        for (const auto& s : samples)
+        {
+            num += (s.simulatedSeconds - meanT) * ((double)s.residentBytes - meanM);
+            den += (s.simulatedSeconds - meanT) * (s.simulatedSeconds - meanT);
+        }
+
+        return den > 0.0 ? num / den * 3600.0 / (1024.0 * 1024.0) : 0.0;
+    }
+
+    int getBucket(double microseconds)
+    {
+        int bucket = 0;
+        for (double limit = 1.0; microseconds >= limit && bucket < kNumHistogramBuckets - 1; limit *= 2.0)
+            ++bucket;
+        return bucket;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    juce::ScopedJuceInitialiser_GUI juceInit;
+
+    double hours = 1.0;
+    int blockSize = 256;
+    double sampleRate = 48000.0;
+    juce::int64 seed = juce::Time::currentTimeMillis();
+    double maxBlockMs = 0.0;
+    double maxGrowthMb = 0.0;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const juce::String arg(argv[i]);
+        const bool hasValue = i + 1 < argc;
+
+        if (arg == "--hours" && hasValue)
+            hours = juce::jmax(0.001, juce::String(argv[++i]).getDoubleValue());
+        else if (arg == "--block" && hasValue)
+            blockSize = juce::jlimit(1, 8192, juce::String(argv[++i]).getIntValue());
+        else if (arg == "--rate" && hasValue)
+            sampleRate = juce::jlimit(8000.0, 384000.0, juce::String(argv[++i]).getDoubleValue());
+        else if (arg == "--seed" && hasValue)
+            seed = juce::String(argv[++i]).getLargeIntValue();
+        else if (arg == "--max-block-ms" && hasValue)
+            maxBlockMs = juce::String(argv[++i]).getDoubleValue();
+        else if (arg == "--max-rss-growth-mb" && hasValue)
+            maxGrowthMb = juce::String(argv[++i]).getDoubleValue();
+        else
+        {
+            std::fprintf(stderr, "usage: SoakHarness [--hours H] [--block N] [--rate SR] [--seed S] "
+                                 "[--max-block-ms X] [--max-rss-growth-mb Y]\n");
+            return 2;
+        }
+    }
+
+    const auto sampleDir = juce::File::getSpecialLocation(juce::File::tempDirectory)
+                               .getChildFile("SlotMachineSoak-" + juce::String(juce::Time::currentTimeMillis()));
+    const auto sampleFiles = SlotHarness::writeEmbeddedSampleFiles(sampleDir, kNumSampleFiles);
+
+    juce::Random rng(seed);
+    SlotMachineAudioProcessor processor;
+    processor.setRateAndBufferSizeDetails(sampleRate, blockSize);
+    processor.prepareToPlay(sampleRate, blockSize);
+
+    createPatterns(processor, sampleFiles, rng);
+    SlotHarness::configureDensePattern(processor, 140.0f);
+
+    juce::AudioBuffer<float> buffer(SlotHarness::getNumOutputChannels(processor), blockSize);
+    juce::MidiBuffer midi;
+    midi.ensureSize(64 * 1024);
+
+    std::atomic<double> simulatedSeconds{ 0.0 };
+    ControlThread control(processor, sampleFiles, simulatedSeconds, rng.nextInt64());
+    control.startThread();
+
+    std::printf("soak: %.2f h simulated, block %d @ %.0f Hz, seed %lld\n", hours, blockSize, sampleRate, (long long)seed);
+    std::printf("%10s %10s %12s %10s %12s\n", "sim min", "wall s", "worst ms", "overruns", "RSS MB");
+
+    using Clock = std::chrono::steady_clock;
+    const auto wallStart = Clock::now();
+    const double budgetUs = 1.0e6 * blockSize / sampleRate;
+    const juce::int64 totalBlocks = (juce::int64)(hours * 3600.0 * sampleRate / blockSize);
+
+    std::array<juce::int64, kNumHistogramBuckets> histogram{};
+    std::vector<MemorySample> memory;
+    double worstUs = 0.0;
+    double worstAtSeconds = 0.0;
+    juce::int64 overruns = 0;
+    double nextReport = kWarmUpSeconds;
+
+    for (juce::int64 b = 0; b < totalBlocks; ++b)
+    {
+        buffer.clear();
+        midi.clear();
+
+        const auto start = Clock::now();
+        processor.processBlock(buffer, midi);
+        const double us = std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+
+        const double now = (double)(b + 1) * blockSize / sampleRate;
+        simulatedSeconds.store(now, std::memory_order_relaxed);
+
+        ++histogram[(size_t)getBucket(us)];
+        if (us > budgetUs)
+            ++overruns;
+
+        // The first blocks load caches and fill buffers; keep them out of the worst case
+        if (now > 1.0 && us > worstUs)
+        {
+            worstUs = us;
+            worstAtSeconds = now;
+        }
+
+        if (now >= nextReport || b + 1 == totalBlocks)
+        {
+            memory.push_back({ now, getResidentBytes() });
+            std::printf("%10.1f %10.1f %12.3f %10lld %12.1f\n",
+                        now / 60.0, std::chrono::duration<double>(Clock::now() - wallStart).count(),
+                        worstUs * 0.001, (long long)overruns, (double)memory.back().residentBytes / (1024.0 * 1024.0));
+            std::fflush(stdout);
+            nextReport += kReportIntervalSeconds;
+        }
+    }
+
+    control.stopThread(5000);
+    processor.releaseResources();
+    sampleDir.deleteRecursively();
+
+    const auto events = control.getEventCounts();
+    std::printf("\nevents: %d automations, %d clicks, %d sample swaps, %d pattern switches\n",
+                events[0], events[1], events[2], events[3]);
+
+    std::printf("\nblock time histogram (budget %.1f us):\n", budgetUs);
+    juce::int64 cumulative = 0;
+    for (int bucket = 0; bucket < kNumHistogramBuckets; ++bucket)
+    {
+        if (histogram[(size_t)bucket] == 0)
+            continue;
+
+        cumulative += histogram[(size_t)bucket];
+        const double upper = std::pow(2.0, (double)bucket);
+        std::printf("  < %9.0f us %12lld %9.5f%%\n", upper, (long long)histogram[(size_t)bucket],
+                    100.0 * (double)cumulative / (double)juce::jmax<juce::int64>(1, totalBlocks));
+    }
+
+    const double growth = getGrowthMbPerHour(memory);
+    const double rssStartMb = memory.empty() ? 0.0 : (double)memory.front().residentBytes / (1024.0 * 1024.0);
+    const double rssEndMb = memory.empty() ? 0.0 : (double)memory.back().residentBytes / (1024.0 * 1024.0);
+
+    std::printf("\nworst block %.3f ms (%.1f%% of budget) at %.1f s; %lld overrun(s)\n",
+                worstUs * 0.001, 100.0 * worstUs / budgetUs, worstAtSeconds, (long long)overruns);
+    std::printf("RSS %.1f MB after warm-up, %.1f MB at end, trend %+.2f MB/hour\n", rssStartMb, rssEndMb, growth);
+
+    bool failed = false;
+    if (maxBlockMs > 0.0 && worstUs * 0.001 > maxBlockMs)
+    {
+        std::printf("FAIL: worst block exceeds %.3f ms\n", maxBlockMs);
+        failed = true;
+    }
+
+    if (maxGrowthMb > 0.0 && rssEndMb - rssStartMb > maxGrowthMb)
+    {
+        std::printf("FAIL: resident memory grew by more than %.1f MB\n", maxGrowthMb);
+        failed = true;
+    }
+
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,147 @@
+// Block render cost for N sounding voices: one full pass over the output per
+// voice (the old per-slot mixInto order) against VoiceBank's tiled render.
+// The bank can read its sources in any sample storage format.
+//
+//   VoiceBankBench [numVoices] [iterations] [float32|int16|float16]
+
+#include "VoiceBank.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+namespace
+{
+    constexpr int kMaxVoices = 128;
+
+    struct Voice
+    {
+        int index = 0;
+        MixKernels::EnvelopeState env;
+        float gainL = 0.5f, gainR = 0.5f;
+    };
+
+    template <typename Fn>
+    double timeNsPerSample (Fn&& fn, int blockSize, int iterations)
+    {
+        using Clock = std::chrono::steady_clock;
+        double best = 1.0e30;
+
+        for (int round = 0; round < 5; ++round)
+        {
+            const auto start = Clock::now();
+            for (int it = 0; it < iterations; ++it)
+                fn();
+            const auto elapsed = std::chrono::duration<double, std::nano> (Clock::now() - start).count();
+            best = std::min (best, elapsed / ((double) iterations * blockSize));
+        }
+
+        return best;
+    }
+}
+
+int main (int argc, char** argv)
+{
+    const int numVoices  = std::clamp (argc > 1 ? std::atoi (argv[1]) : 32, 1, kMaxVoices);
+    const int iterations = argc > 2 ? std::max (1, std::atoi (argv[2])) : 200;
+    const char* formatName = argc > 3 ? argv[3] : "float32";
+
+    auto format = MixKernels::SourceFormat::float32;
+    if (std::strcmp (formatName, "int16") == 0)        format = MixKernels::SourceFormat::int16;
+    else if (std::strcmp (formatName, "float16") == 0) format = MixKernels::SourceFormat::float16;
+    else formatName = "float32";
+
+    const int sampleLength = 1 << 20;
+    std::mt19937 rng (99);
+    std::uniform_real_distribution<float> dist (-1.0f, 1.0f);
+
+    // Each voice plays its own stereo sample, as slots do
+    std::vector<std::vector<float>> samples ((size_t) numVoices * 2);
+    for (auto& channel : samples)
+    {
+        channel.resize ((size_t) sampleLength);
+        for (auto& v : channel)
+            v = dist (rng);
+    }
+
+    // The same material in the bank's storage format
+    std::vector<std::vector<int16_t>> compact (samples.size());
+    for (size_t c = 0; c < samples.size(); ++c)
+    {
+        compact[c].resize ((size_t) sampleLength);
+        for (size_t i = 0; i < (size_t) sampleLength; ++i)
+            compact[c][i] = format == MixKernels::SourceFormat::float16
+                                ? (int16_t) MixKernels::Half::fromFloat (samples[c][i]).bits
+                                : (int16_t) std::lround (samples[c][i] * 32767.0f);
+    }
+
+    auto bankSource = [&] (size_t channel) -> const void*
+    {
+        return format == MixKernels::SourceFormat::float32 ? (const void*) samples[channel].data()
+                                                           : (const void*) compact[channel].data();
+    };
+    const float sourceScale = format == MixKernels::SourceFormat::int16 ? 1.0f / 32767.0f : 1.0f;
+
+    const float alpha = (float) std::pow (0.001, 1.0 / (2.0 * 48000.0));
+
+    std::printf ("%d voices, %d iterations (best of 5), bank reads %s\n", numVoices, iterations, formatName);
+    std::printf ("%8s %16s %16s %9s\n", "block", "per-voice ns/s", "bank ns/s", "speedup");
+
+    for (int blockSize : { 64, 256, 1024, 4096, 16384 })
+    {
+        std::vector<float> outL ((size_t) blockSize), outR ((size_t) blockSize);
+
+        // Per-voice passes, restarting playback when the sample runs out
+        std::vector<Voice> voices ((size_t) numVoices);
+        const double perVoiceNs = timeNsPerSample ([&]
+        {
+            for (int v = 0; v < numVoices; ++v)
+            {
+                auto& voice = voices[(size_t) v];
+                if (voice.index + blockSize > sampleLength)
+                    voice = {};
+
+                voice.env.alpha = alpha;
+                MixKernels::mixVoice (samples[(size_t) v * 2].data() + voice.index,
+                                      samples[(size_t) v * 2 + 1].data() + voice.index,
+                                      outL.data(), outR.data(), blockSize,
+                                      voice.gainL, voice.gainR, voice.env);
+                voice.index += blockSize;
+                if (voice.env.level < 1.0e-3f)
+                    voice.env.level = 1.0f;
+            }
+        }, blockSize, iterations);
+
+        VoiceBank<kMaxVoices> bank;
+        const double bankNs = timeNsPerSample ([&]
+        {
+            for (int v = 0; v < numVoices; ++v)
+            {
+                if (bank.isActive (v) && bank.getPlayIndex (v) + blockSize <= sampleLength
+                    && bank.getEnvelope (v) >= 1.0e-3f)
+                    continue;
+
+                bank.start (v, format, sourceScale, bankSource ((size_t) v * 2), bankSource ((size_t) v * 2 + 1),
+                            0, sampleLength, 1.0f, alpha, 0);
+                bank.setGains (v, 0.5f, 0.5f, 0.5f);
+            }
+
+            bank.render (outL.data(), outR.data(), blockSize);
+        }, blockSize, iterations);
+
+        std::printf ("%8d %16.3f %16.3f %8.2fx\n", blockSize, perVoiceNs, bankNs, perVoiceNs / bankNs);
+
+        double sink = 0.0;
+        for (int i = 0; i < blockSize; ++i)
+            sink += outL[(size_t) i] + outR[(size_t) i];
+        if (sink == 12345.678)
+            std::printf ("!\n");
+    }
+
+    return 0;
+}
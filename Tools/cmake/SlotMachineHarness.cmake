@@ -0,0 +1,115 @@
+# Builds the plugin's processor and editor sources straight into console apps, so
+# benchmarks and harnesses can drive SlotMachineAudioProcessor without a host.
+# Included from Tools/CMakeLists.txt only when a JUCE checkout is available.
+
+include_guard(GLOBAL)
+
+set(SLOTMACHINE_TOOLS_DIR "${CMAKE_CURRENT_LIST_DIR}/..")
+set(SLOTMACHINE_RESOURCES_DIR "${SLOTMACHINE_TOOLS_DIR}/../Resources")
+
+set(SLOTMACHINE_PLUGIN_SOURCES
+    "${SLOTMACHINE_SOURCE_DIR}/PluginProcessor.cpp"
+    "${SLOTMACHINE_SOURCE_DIR}/PluginEditor.cpp"
+    "${SLOTMACHINE_SOURCE_DIR}/BeatsQuickPickGrid.cpp"
+    "${SLOTMACHINE_SOURCE_DIR}/CountBeatMaskGrid.cpp"
+    "${SLOTMACHINE_SOURCE_DIR}/PolyrhythmVizComponent.cpp"
+    "${SLOTMACHINE_SOURCE_DIR}/AuditionEngine.cpp"
+    "${SLOTMACHINE_SOURCE_DIR}/DeferredRelease.cpp"
+    "${SLOTMACHINE_SOURCE_DIR}/RenderWorkerPool.cpp"
+    "${SLOTMACHINE_SOURCE_DIR}/RealtimeWake.cpp"
+    "${SLOTMACHINE_SOURCE_DIR}/RealtimeSafetyCheck.cpp"
+    "${SLOTMACHINE_SOURCE_DIR}/AudioTrace.cpp"
+    "${SLOTMACHINE_SOURCE_DIR}/SampleDiskCache.cpp"
+    "${SLOTMACHINE_SOURCE_DIR}/SampleMemoryManager.cpp")
+
+# Same resource list as NewProject.jucer, so BinaryData symbol names match the plugin build
+juce_add_binary_data(SlotMachineBinaryData
+    NAMESPACE BinaryData
+    HEADER_NAME BinaryData.h
+    SOURCES
+    "${SLOTMACHINE_RESOURCES_DIR}/Open Source Wav Files/CYMBAL-Bell.wav"
+    "${SLOTMACHINE_RESOURCES_DIR}/Open Source Wav Files/CYMBAL-Crash 2.wav"
+    "${SLOTMACHINE_RESOURCES_DIR}/Open Source Wav Files/CYMBAL-Crash.wav"
+    "${SLOTMACHINE_RESOURCES_DIR}/Open Source Wav Files/CYMBAL-Ride 2.wav"
+    "${SLOTMACHINE_RESOURCES_DIR}/Open Source Wav Files/CYMBAL-Ride 3.wav"
+    "${SLOTMACHINE_RESOURCES_DIR}/Open Source Wav Files/CYMBAL-Ride.wav"
+    "${SLOTMACHINE_RESOURCES_DIR}/Open Source Wav Files/CYMBAL-Tap.wav"
+    "${SLOTMACHINE_RESOURCES_DIR}/Open Source Wav Files/HAT-Closed 2.wav"
+    "${SLOTMACHINE_RESOURCES_DIR}/Open Source Wav Files/HAT-Closed.wav"
+    "${SLOTMACHINE_RESOURCES_DIR}/Open Source Wav Files/HAT-Open 2.wav"
+    "${SLOTMACHINE_RESOURCES_DIR}/Open Source Wav Files/HAT-Open.wav"
+    "${SLOTMACHINE_RESOURCES_DIR}/Open Source Wav Files/HAT-Pedal.wav"
+    "${SLOTMACHINE_RESOURCES_DIR}/Open Source Wav Files/HAT-Tap.wav"
+    "${SLOTMACHINE_RESOURCES_DIR}/Open Source Wav Files/KICK-Kick 1.wav"
+    "${SLOTMACHINE_RESOURCES_DIR}/Open Source Wav Files/KICK-Kick 2.wav"
+    "${SLOTMACHINE_RESOURCES_DIR}/Open Source Wav Files/KICK-Kick 3.wav"
+    "${SLOTMACHINE_RESOURCES_DIR}/Open Source Wav Files/KICK-Kick 4.wav"
+    "${SLOTMACHINE_RESOURCES_DIR}/Open Source Wav Files/KICK-Kick 5.wav"
+    "${SLOTMACHINE_RESOURCES_DIR}/Open Source Wav Files/KICK-Kick 6.wav"
+    "${SLOTMACHINE_RESOURCES_DIR}/Open Source Wav Files/RIMSHOT-Rimshot 1.wav"
+    "${SLOTMACHINE_RESOURCES_DIR}/Open Source Wav Files/RIMSHOT-Rimshot 2.wav"
+    "${SLOTMACHINE_RESOURCES_DIR}/Open Source Wav Files/RIMSHOT-Rimshot 3.wav"
+    "${SLOTMACHINE_RESOURCES_DIR}/Open Source Wav Files/RIMSHOT-Rimshot 4.wav"
+    "${SLOTMACHINE_RESOURCES_DIR}/Open Source Wav Files/RIMSHOT-Rimshot 5.wav"
+    "${SLOTMACHINE_RESOURCES_DIR}/Open Source Wav Files/SNARE-Snare 1.wav"
+    "${SLOTMACHINE_RESOURCES_DIR}/Open Source Wav Files/SNARE-Snare 2.wav"
+    "${SLOTMACHINE_RESOURCES_DIR}/Open Source Wav Files/SNARE-Snare 3.wav"
+    "${SLOTMACHINE_RESOURCES_DIR}/Open Source Wav Files/SNARE-Snare 4.wav"
+    "${SLOTMACHINE_RESOURCES_DIR}/Open Source Wav Files/SNARE-Snare 5.wav"
+    "${SLOTMACHINE_RESOURCES_DIR}/Open Source Wav Files/TOM-Floor 2.wav"
+    "${SLOTMACHINE_RESOURCES_DIR}/Open Source Wav Files/TOM-Floor.wav"
+    "${SLOTMACHINE_RESOURCES_DIR}/Open Source Wav Files/TOM-High 2.wav"
+    "${SLOTMACHINE_RESOURCES_DIR}/Open Source Wav Files/TOM-High 3.wav"
+    "${SLOTMACHINE_RESOURCES_DIR}/Open Source Wav Files/TOM-High 4.wav"
+    "${SLOTMACHINE_RESOURCES_DIR}/Open Source Wav Files/TOM-High.wav"
+    "${SLOTMACHINE_RESOURCES_DIR}/Open Source Wav Files/TOM-Low 2.wav"
+    "${SLOTMACHINE_RESOURCES_DIR}/Open Source Wav Files/TOM-Low 3.wav"
+    "${SLOTMACHINE_RESOURCES_DIR}/Open Source Wav Files/TOM-Low 4.wav"
+    "${SLOTMACHINE_RESOURCES_DIR}/Open Source Wav Files/TOM-Low.wav"
+    "${SLOTMACHINE_RESOURCES_DIR}/Open Source Wav Files/TOM-Mid 2.wav"
+    "${SLOTMACHINE_RESOURCES_DIR}/Open Source Wav Files/TOM-Mid 3.wav"
+    "${SLOTMACHINE_RESOURCES_DIR}/Open Source Wav Files/TOM-Mid.wav"
+    "${SLOTMACHINE_RESOURCES_DIR}/Images/SpeakerIcon.png"
+    "${SLOTMACHINE_RESOURCES_DIR}/Images/LonePearLogic.png"
+    "${SLOTMACHINE_RESOURCES_DIR}/Images/MuteOFF.png"
+    "${SLOTMACHINE_RESOURCES_DIR}/Images/MuteON.png"
+    "${SLOTMACHINE_RESOURCES_DIR}/SlotMachine-UserManual.html"
+    "${SLOTMACHINE_RESOURCES_DIR}/SlotMachine.ico"
+    "${SLOTMACHINE_RESOURCES_DIR}/Images/SM5.png"
+    "${SLOTMACHINE_RESOURCES_DIR}/Images/SoloOFF.png"
+    "${SLOTMACHINE_RESOURCES_DIR}/Images/SoloON.png")
+
+# slotmachine_add_harness(<target> SOURCES <files...> [NUM_SLOTS 16|32|64] [DEFINITIONS <defs...>])
+function(slotmachine_add_harness target)
+    cmake_parse_arguments(ARG "" "NUM_SLOTS" "SOURCES;DEFINITIONS" ${ARGN})
+
+    if(NOT ARG_NUM_SLOTS)
+        set(ARG_NUM_SLOTS 16)
+    endif()
+
+    juce_add_console_app(${target} PRODUCT_NAME ${target})
+
+    target_sources(${target} PRIVATE ${ARG_SOURCES} ${SLOTMACHINE_PLUGIN_SOURCES})
+    target_include_directories(${target} PRIVATE "${SLOTMACHINE_SOURCE_DIR}" "${SLOTMACHINE_TOOLS_DIR}/common")
+
+    # Plugin settings normally supplied by JucePluginDefines.h
+    target_compile_definitions(${target} PRIVATE
+        SLOTMACHINE_NUM_SLOTS=${ARG_NUM_SLOTS}
+        JucePlugin_Name="SlotMachine"
+        JucePlugin_Manufacturer="Lone Pear Logic"
+        JucePlugin_IsSynth=1
+        JucePlugin_IsMidiEffect=0
+        JucePlugin_WantsMidiInput=1
+        JucePlugin_ProducesMidiOutput=1
+        JUCE_WEB_BROWSER=0
+        JUCE_USE_CURL=0
+        JUCE_STRICT_REFCOUNTEDPOINTER=1
+        ${ARG_DEFINITIONS})
+
+    target_link_libraries(${target} PRIVATE
+        SlotMachineBinaryData
+        juce::juce_audio_utils
+        juce::juce_gui_extra
+        juce::juce_recommended_config_flags
+        juce::juce_recommended_warning_flags)
+endfunction()
@@ -0,0 +1,113 @@
+#pragma once
+
+// Shared set-up for the console harnesses that drive SlotMachineAudioProcessor
+// directly: parameter access, embedded sample loading and a repeatable pattern.
+
+#include "PluginProcessor.h"
+#include "BinaryData.h"
+
+#include <juce_audio_utils/juce_audio_utils.h>
+#include <iterator>
+
+namespace SlotHarness
+{
+    constexpr int kNumSlots = SlotMachineAudioProcessor::kNumSlots;
+
+    inline juce::String slotParamId(int slotIndex, const juce::String& suffix)
+    {
+        return "slot" + juce::String(slotIndex + 1) + "_" + suffix;
+    }
+
+    inline void setParam(SlotMachineAudioProcessor& processor, const juce::String& id, float value)
+    {
+        if (auto* param = processor.apvts.getParameter(id))
+            param->setValueNotifyingHost(param->convertTo0to1(value));
+    }
+
+    inline float getParam(SlotMachineAudioProcessor& processor, const juce::String& id)
+    {
+        if (auto* raw = processor.apvts.getRawParameterValue(id))
+            return raw->load();
+        return 0.0f;
+    }
+
+    // Loads the embedded one-shots round-robin into the first numSlotsToLoad slots and
+    // returns how many slots ended up with a sample.
+    inline int loadEmbeddedSamples(SlotMachineAudioProcessor& processor, int numSlotsToLoad)
+    {
+        juce::StringArray wavResources;
+        for (int i = 0; i < BinaryData::namedResourceListSize; ++i)
+        {
+            const juce::String name(BinaryData::namedResourceList[i]);
+            if (name.endsWithIgnoreCase("_wav"))
+                wavResources.add(name);
+        }
+
+        if (wavResources.isEmpty())
+            return 0;
+
+        int loaded = 0;
+        for (int slot = 0; slot < juce::jmin(numSlotsToLoad, kNumSlots); ++slot)
+        {
+            const auto& name = wavResources[slot % wavResources.size()];
+            int size = 0;
+            if (const void* data = BinaryData::getNamedResource(name.toRawUTF8(), size))
+                if (processor.loadSampleForSlotFromMemory(slot, data, size, name))
+                    ++loaded;
+        }
+
+        return loaded;
+    }
+
+    // Writes up to maxFiles of the embedded one-shots into dir as .wav files, for harnesses
+    // that need slots loaded from disk (patterns and exports refer to samples by path)
+    inline juce::Array<juce::File> writeEmbeddedSampleFiles(const juce::File& dir, int maxFiles)
+    {
+        juce::Array<juce::File> files;
+        dir.createDirectory();
+
+        for (int i = 0; i < BinaryData::namedResourceListSize && files.size() < maxFiles; ++i)
+        {
+            const juce::String name(BinaryData::namedResourceList[i]);
+            if (!name.endsWithIgnoreCase("_wav"))
+                continue;
+
+            int size = 0;
+            if (const void* data = BinaryData::getNamedResource(name.toRawUTF8(), size))
+            {
+                auto file = dir.getChildFile(name + ".wav");
+                if (file.replaceWithData(data, (size_t)size))
+                    files.add(file);
+            }
+        }
+
+        return files;
+    }
+
+    // A dense but deterministic polyrhythm: every loaded slot runs at its own rate with a
+    // long decay so tails overlap, which is the expensive case for the engine.
+    inline void configureDensePattern(SlotMachineAudioProcessor& processor, float bpm)
+    {
+        static constexpr float rates[] = { 1.0f, 1.5f, 2.0f, 0.75f, 3.0f, 1.25f, 4.0f, 0.5f };
+
+        setParam(processor, "optTimingMode", 0.0f);
+        setParam(processor, "masterBPM", bpm);
+
+        for (int i = 0; i < kNumSlots; ++i)
+        {
+            setParam(processor, slotParamId(i, "Mute"), 0.0f);
+            setParam(processor, slotParamId(i, "Solo"), 0.0f);
+            setParam(processor, slotParamId(i, "Rate"), rates[i % (int)std::size(rates)]);
+            setParam(processor, slotParamId(i, "Gain"), 50.0f);
+            setParam(processor, slotParamId(i, "Pan"), (float)((i % 5) - 2) * 0.4f);
+        }
+
+        setParam(processor, "masterRun", 1.0f);
+    }
+
+    // Output layout the processor was built with (stereo unless the bus layout says otherwise)
+    inline int getNumOutputChannels(SlotMachineAudioProcessor& processor)
+    {
+        return juce::jmax(1, processor.getTotalNumOutputChannels());
+    }
+}